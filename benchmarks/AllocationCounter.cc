@@ -0,0 +1,79 @@
+//This file replaces the global operator new/delete family so heap allocations can be counted.
+//
+// The replacements live in their own translation unit so the compiler cannot inline them into callers. When it can,
+// it sees free() applied to pointers obtained from new-expressions and warns (-Wmismatched-new-delete). Every
+// replaceable form (array, sized, aligned, and nothrow) is replaced so all allocations are counted and every
+// deallocation reaches the matching allocator.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+#include <new>
+
+#include "AllocationCounter.hpp"
+
+static std::atomic<uint64_t> Count(0);
+
+uint64_t HeapAllocationCount(void){
+    return Count.load(std::memory_order_relaxed);
+}
+
+static void * CountedAllocate(std::size_t n) noexcept {
+    Count.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(n == 0 ? 1 : n);
+}
+
+static void * CountedAllocate(std::size_t n, std::align_val_t a) noexcept {
+    Count.fetch_add(1, std::memory_order_relaxed);
+    //std::aligned_alloc() requires the size to be a multiple of the alignment.
+    const auto Align = static_cast<std::size_t>(a);
+    const std::size_t Size = ((std::max<std::size_t>(n, 1) + Align - 1) / Align) * Align;
+    return std::aligned_alloc(Align, Size);
+}
+
+//Plain.
+void * operator new(std::size_t n){
+    if(void *p = CountedAllocate(n)) return p;
+    throw std::bad_alloc();
+}
+void * operator new[](std::size_t n){
+    if(void *p = CountedAllocate(n)) return p;
+    throw std::bad_alloc();
+}
+void * operator new(std::size_t n, const std::nothrow_t &) noexcept {
+    return CountedAllocate(n);
+}
+void * operator new[](std::size_t n, const std::nothrow_t &) noexcept {
+    return CountedAllocate(n);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+//Over-aligned.
+void * operator new(std::size_t n, std::align_val_t a){
+    if(void *p = CountedAllocate(n, a)) return p;
+    throw std::bad_alloc();
+}
+void * operator new[](std::size_t n, std::align_val_t a){
+    if(void *p = CountedAllocate(n, a)) return p;
+    throw std::bad_alloc();
+}
+void * operator new(std::size_t n, std::align_val_t a, const std::nothrow_t &) noexcept {
+    return CountedAllocate(n, a);
+}
+void * operator new[](std::size_t n, std::align_val_t a, const std::nothrow_t &) noexcept {
+    return CountedAllocate(n, a);
+}
+
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t, const std::nothrow_t &) noexcept { std::free(p); }
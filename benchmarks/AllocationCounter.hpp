@@ -0,0 +1,10 @@
+
+#ifndef YGOR_CLUSTERING_BENCHMARKS_ALLOCATIONCOUNTER_HPP
+#define YGOR_CLUSTERING_BENCHMARKS_ALLOCATIONCOUNTER_HPP
+
+#include <cstdint>
+
+//The number of heap allocations performed so far through the global operator new family. See AllocationCounter.cc.
+uint64_t HeapAllocationCount(void);
+
+#endif //YGOR_CLUSTERING_BENCHMARKS_ALLOCATIONCOUNTER_HPP
@@ -0,0 +1,393 @@
+
+//This program times the main clustering routines over a range of synthetic data shapes, dimensions, and sizes,
+// and writes the results as JSON so throughput can be tracked across releases. It is built and run by the 'bench'
+// CMake target, but can also be invoked directly:
+//
+//     ygorclustering_bench [--output bench.json] [--min-points 1000] [--max-points 10000000]
+//                          [--nearby-max-points 10000] [--seed 9137] [--threads N]
+//
+// All data is generated from a fixed seed, so every run (and every release) sees identical inputs. Data is scaled
+// so that the mean number of datum within Eps of a uniformly-distributed datum stays roughly constant as the
+// number of datum grows, so timings for different sizes remain comparable.
+//
+// Every configuration is run with double ('f64'), float ('f32'), and fixed-point int32_t ('i32') coordinates so the
+// effect of reduced-precision storage can be compared. The double variants are also run with R*-trees allocated from
+// a ClusteringArena ('arena' rather than 'default' allocator). 2D and 3D double variants also compare R*-tree and
+// space-filling curve traversal orders, on both bulk-loaded and (up to 10^6 datum) insertion-built trees.
+//
+// NOTE: The UseNearby technique scales poorly (each query walks Boost.Geometry's incremental nearest-neighbour
+//       iterator over the whole tree), so by default it is only timed for small inputs.
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <array>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <string>
+#include <random>
+#include <sstream>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <new>
+#include <cstdlib>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+#include <boost/version.hpp>
+
+//Inserting into an R*-tree of (trivially copyable) ClusteringDatum makes GCC warn that Boost's reinsertion heap may
+// read an uninitialized element of its fixed-capacity scratch array. It only ever reads elements it has written, so
+// the warning is spurious. The heap code is inlined into Boost's R*-tree insertion visitor, and GCC matches the
+// pragma against that location, so it has to be in effect where the R*-tree headers are first included.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include "YgorClustering.hpp"
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#include "AllocationCounter.hpp" //Counts heap allocations alongside timings.
+
+
+struct BenchmarkResult {
+    std::string Coordinates;
+    std::string Allocator;
+    std::string Shape;
+    size_t Dimension;
+    size_t Points;
+    std::string Operation;
+    std::string Technique;
+    std::string Traversal;
+    double Eps;
+    size_t MinPts;
+    double Seconds;
+    uint64_t Allocations;
+    size_t Clusters;
+    size_t Noise;
+};
+
+//Times a single operation, recording wall time and the number of heap allocations performed.
+template <typename Operation_t>
+void TimeOperation(BenchmarkResult &Result, Operation_t Op){
+    const auto AllocationsBefore = HeapAllocationCount();
+    const auto TimeBefore = std::chrono::steady_clock::now();
+    Op();
+    const auto TimeAfter = std::chrono::steady_clock::now();
+    const auto AllocationsAfter = HeapAllocationCount();
+    Result.Seconds = std::chrono::duration<double>(TimeAfter - TimeBefore).count();
+    Result.Allocations = AllocationsAfter - AllocationsBefore;
+    return;
+}
+
+
+//Synthetic data generators. Datum are placed in the box [0,L]^D, where L is chosen so the expected number of
+// uniformly-distributed datum within Eps = 1 of any datum is about 2*MinPts.
+//
+// - "uniform": all datum are uniformly distributed.
+// - "blobs": datum are drawn from isotropic Gaussian blobs of ~10^4 datum each, with centres uniformly distributed.
+// - "dense_noise": 90% of datum are drawn from tighter Gaussian blobs and 10% are uniform background noise.
+//
+template <size_t D>
+std::vector<ClusteringDatum<D, double, 0, double, uint32_t>>
+GenerateData(const std::string &Shape, size_t N, size_t MinPts, uint64_t Seed){
+    typedef ClusteringDatum<D, double, 0, double, uint32_t> CDat_t;
+
+    const double Pi = 3.14159265358979323846;
+    const double UnitBallVolume = (D == 1) ? 2.0 : ( (D == 2) ? Pi : (4.0 * Pi / 3.0) );
+    const double Density = (2.0 * static_cast<double>(MinPts)) / UnitBallVolume;
+    const double L = std::pow(static_cast<double>(N) / Density, 1.0 / static_cast<double>(D));
+
+    const size_t BlobCount = std::max<size_t>(1, N / 10'000);
+    const double BlobScale = L / std::pow(static_cast<double>(BlobCount), 1.0 / static_cast<double>(D));
+
+    std::mt19937_64 re(Seed);
+    std::uniform_real_distribution<double> ud(0.0, L);
+    std::normal_distribution<double> nd(0.0, 1.0);
+
+    std::vector<std::array<double, D>> Centres(BlobCount);
+    for(auto &c : Centres) for(auto &x : c) x = ud(re);
+
+    double Sigma = 0.0;
+    double NoiseFraction = 1.0;
+    if(Shape == "uniform"){
+        NoiseFraction = 1.0;
+    }else if(Shape == "blobs"){
+        Sigma = 0.25 * BlobScale;
+        NoiseFraction = 0.0;
+    }else if(Shape == "dense_noise"){
+        Sigma = 0.15 * BlobScale;
+        NoiseFraction = 0.1;
+    }else{
+        throw std::runtime_error("Unrecognized data shape '" + Shape + "'.");
+    }
+    std::uniform_real_distribution<double> fd(0.0, 1.0);
+    std::uniform_int_distribution<size_t> cd(0, BlobCount - 1);
+
+    std::vector<CDat_t> out;
+    out.reserve(N);
+    for(size_t i = 0; i < N; ++i){
+        std::array<double, D> c;
+        if(fd(re) < NoiseFraction){
+            for(auto &x : c) x = ud(re);
+        }else{
+            const auto &Centre = Centres[cd(re)];
+            for(size_t d = 0; d < D; ++d) c[d] = Centre[d] + Sigma * nd(re);
+        }
+        out.push_back(CDat_t(c));
+    }
+    return out;
+}
+
+
+template <typename SpatialType> const char * CoordinateName(void);
+template <> const char * CoordinateName<double>(void){ return "f64"; }
+template <> const char * CoordinateName<float>(void){ return "f32"; }
+template <> const char * CoordinateName<int32_t>(void){ return "i32"; }
+
+//When UseArena is true, the R*-tree (and DBSCAN's scratch buffers) are allocated from a ClusteringArena.
+template <size_t D, typename SpatialType, bool UseArena = false>
+void RunShape(const std::string &Shape, size_t N, uint64_t Seed, size_t ThreadCount, size_t NearbyMaxPoints,
+              std::vector<BenchmarkResult> &Results){
+    typedef ClusteringDatum<D, SpatialType, 0, double, uint32_t> CDat_t;
+    typedef boost::geometry::index::rstar<16> RTreeParameter_t;
+    typedef typename std::conditional< UseArena,
+                                       ClusteringArenaAllocator<CDat_t>,
+                                       boost::container::new_allocator<CDat_t> >::type Allocator_t;
+    typedef boost::geometry::index::rtree< CDat_t,
+                                           RTreeParameter_t,
+                                           boost::geometry::index::indexable<CDat_t>,
+                                           boost::geometry::index::equal_to<CDat_t>,
+                                           Allocator_t > RTree_t;
+
+    const size_t MinPts = CDat_t::SpatialDimensionCount_ * 2;
+
+    //Generate double-precision data and convert it. Fixed-point coordinates span about a quarter of the int32_t
+    // range, which leaves ~7 significant digits even for the largest inputs.
+    std::vector<CDat_t> Data;
+    typename CDat_t::DistanceType_ Eps = 1.0;
+    {
+        const auto Source = GenerateData<D>(Shape, N, MinPts, Seed);
+        double Extent = 1.0;
+        for(const auto &P : Source) for(const auto &x : P.Coordinates) Extent = std::max(Extent, std::abs(x));
+        const FixedPointCoordinateCodec<D, int32_t> Codec(std::array<double, D>(), Extent / std::pow(2.0, 29.0));
+        Data.reserve(N);
+        for(const auto &P : Source){
+            if constexpr (std::is_integral<SpatialType>::value){
+                Data.push_back(CDat_t(Codec.Encode(P.Coordinates)));
+            }else{
+                std::array<SpatialType, D> c;
+                for(size_t d = 0; d < D; ++d) c[d] = static_cast<SpatialType>(P.Coordinates[d]);
+                Data.push_back(CDat_t(c));
+            }
+        }
+        if constexpr (std::is_integral<SpatialType>::value) Eps = Codec.EncodeDistance(1.0);
+    }
+
+    BenchmarkResult Base = { CoordinateName<SpatialType>(), (UseArena ? "arena" : "default"), Shape, D, N, "", "", "rtree", 1.0, MinPts, 0.0, 0, 0, 0 };
+    const auto Report = [&](const BenchmarkResult &R) -> void {
+        std::cerr << R.Coordinates << " " << R.Allocator << " " << R.Shape << " " << R.Dimension << "D " << R.Points << " " << R.Operation
+                  << (R.Technique.empty() ? "" : " " + R.Technique)
+                  << ((R.Traversal == "rtree") ? "" : " " + R.Traversal) << ": " << R.Seconds << " s" << std::endl;
+        Results.push_back(R);
+    };
+
+    RTree_t rtree;
+    {
+        BenchmarkResult R = Base;
+        R.Operation = "build_packed_rtree";
+        TimeOperation(R, [&]() -> void { rtree = BuildPackedRTree<RTree_t, CDat_t>(Data); });
+        Report(R);
+    }
+
+    //Compare traversal orders (see ClusteringTraversalOrder). Bulk-loaded trees are already traversed in a spatially
+    // coherent order, so trees built by repeated insertion are also compared, up to a moderate size.
+    if constexpr (std::is_same<SpatialType, double>::value && !UseArena && (2 <= D)){
+        const std::vector<std::pair<std::string, ClusteringTraversalOrder>> Orders = {
+            { "rtree",   ClusteringTraversalOrder::RTree   },
+            { "morton",  ClusteringTraversalOrder::Morton  },
+            { "hilbert", ClusteringTraversalOrder::Hilbert } };
+        const auto CompareTraversals = [&](RTree_t &Tree, const std::string &Suffix) -> void {
+            for(const auto &o : Orders){
+                DBSCANOptions Options;
+                Options.TraversalOrder = o.second;
+                Options.TraversalThreadCount = ThreadCount;
+
+                BenchmarkResult R = Base;
+                R.Operation = "dbscan_traversal" + Suffix;
+                R.Technique = "UseWithin";
+                R.Traversal = o.first;
+                TimeOperation(R, [&]() -> void {
+                    DBSCAN<RTree_t, CDat_t>(Tree, Eps, MinPts, SpatialQueryTechnique::UseWithin, nullptr, &Options);
+                });
+                Report(R);
+
+                std::vector<ClusterID<typename CDat_t::ClusterIDType_>> Labels;
+                R.Operation = "dbscan_parallel" + Suffix;
+                TimeOperation(R, [&]() -> void {
+                    DBSCANParallel<RTree_t, CDat_t>(static_cast<const RTree_t &>(Tree), Labels, Eps, MinPts,
+                                                    SpatialQueryTechnique::UseWithin, ThreadCount, &Options);
+                });
+                Report(R);
+            }
+        };
+        CompareTraversals(rtree, "");
+
+        constexpr size_t InsertMaxPoints = 1'000'000;
+        if(N <= InsertMaxPoints){
+            RTree_t Inserted;
+            BenchmarkResult R = Base;
+            R.Operation = "build_inserted_rtree";
+            TimeOperation(R, [&]() -> void { for(const auto &P : Data) Inserted.insert(P); });
+            Report(R);
+            CompareTraversals(Inserted, "_inserted");
+        }
+    }
+
+    Data.clear();
+    Data.shrink_to_fit();
+
+    //DBSCAN() clusters 1D datum by sorting regardless of the R*-tree query technique, so only one such row is timed.
+    const std::vector<std::pair<std::string, SpatialQueryTechnique>> Techniques = (D == 1)
+        ? std::vector<std::pair<std::string, SpatialQueryTechnique>>{
+            { "sort_and_sweep", SpatialQueryTechnique::UseWithin },
+            { "UseGrid",        SpatialQueryTechnique::UseGrid   } }
+        : std::vector<std::pair<std::string, SpatialQueryTechnique>>{
+            { "UseNearby", SpatialQueryTechnique::UseNearby },
+            { "UseWithin", SpatialQueryTechnique::UseWithin },
+            { "UseRadius", SpatialQueryTechnique::UseRadius },
+            { "UseGrid",   SpatialQueryTechnique::UseGrid   } };
+    for(const auto &t : Techniques){
+        if((t.second == SpatialQueryTechnique::UseNearby) && (NearbyMaxPoints < N)) continue;
+        BenchmarkResult R = Base;
+        R.Operation = "dbscan";
+        R.Technique = t.first;
+        TimeOperation(R, [&]() -> void { DBSCAN<RTree_t, CDat_t>(rtree, Eps, MinPts, t.second); });
+        for(const auto &c : GetClusterIDCounts<RTree_t, CDat_t>(rtree)){
+            if(c.first.IsNoise()) R.Noise += c.second;
+            if(c.first.IsRegular()) R.Clusters += 1;
+        }
+        Report(R);
+    }
+
+    {
+        BenchmarkResult R = Base;
+        R.Operation = "sorted_kdist_graph";
+        TimeOperation(R, [&]() -> void { DBSCANSortedkDistGraph<RTree_t, CDat_t>(rtree, MinPts, ThreadCount); });
+        Report(R);
+    }
+
+    {
+        BenchmarkResult R = Base;
+        R.Operation = "destroy_rtree";
+        TimeOperation(R, [&]() -> void { rtree = RTree_t(); });
+        Report(R);
+    }
+    return;
+}
+
+
+std::string JSONEscape(const std::string &in){
+    std::string out;
+    for(const auto c : in){
+        if((c == '"') || (c == '\\')) out += '\\';
+        if(static_cast<unsigned char>(c) < 0x20){
+            out += ' ';
+            continue;
+        }
+        out += c;
+    }
+    return out;
+}
+
+
+int main(int argc, char **argv){
+    std::string OutputFilename = "bench.json";
+    size_t MinPoints = 1'000;
+    size_t MaxPoints = 10'000'000;
+    size_t NearbyMaxPoints = 10'000;
+    uint64_t Seed = 9137;
+    size_t ThreadCount = DefaultClusteringThreadCount();
+
+    for(int i = 1; i < argc; ++i){
+        const std::string Arg = argv[i];
+        if((i + 1) == argc) throw std::runtime_error("Missing value for argument '" + Arg + "'.");
+        const std::string Value = argv[++i];
+        if(Arg == "--output"){
+            OutputFilename = Value;
+        }else if(Arg == "--min-points"){
+            MinPoints = std::stoull(Value);
+        }else if(Arg == "--max-points"){
+            MaxPoints = std::stoull(Value);
+        }else if(Arg == "--nearby-max-points"){
+            NearbyMaxPoints = std::stoull(Value);
+        }else if(Arg == "--seed"){
+            Seed = std::stoull(Value);
+        }else if(Arg == "--threads"){
+            ThreadCount = std::stoull(Value);
+        }else{
+            throw std::runtime_error("Unrecognized argument '" + Arg + "'.");
+        }
+    }
+
+    std::vector<BenchmarkResult> Results;
+    for(const std::string Shape : { "uniform", "blobs", "dense_noise" }){
+        for(size_t N = 1'000; N <= MaxPoints; N *= 10){
+            if(N < MinPoints) continue;
+            RunShape<1, double>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<2, double>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<3, double>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<1, double, true>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<2, double, true>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<3, double, true>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<1, float>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<2, float>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<3, float>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<1, int32_t>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<2, int32_t>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+            RunShape<3, int32_t>(Shape, N, Seed, ThreadCount, NearbyMaxPoints, Results);
+        }
+    }
+
+    std::ofstream FO(OutputFilename);
+    FO.precision(9);
+    FO << "{\n"
+       << "  \"library\": \"YgorClustering\",\n"
+       << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n"
+       << "  \"compiler\": \"" << JSONEscape(__VERSION__) << "\",\n"
+       << "  \"boost_version\": \"" << BOOST_LIB_VERSION << "\",\n"
+       << "  \"seed\": " << Seed << ",\n"
+       << "  \"threads\": " << ThreadCount << ",\n"
+       << "  \"results\": [\n";
+    for(size_t i = 0; i < Results.size(); ++i){
+        const auto &R = Results[i];
+        FO << "    { \"coordinates\": \"" << R.Coordinates << "\""
+           << ", \"allocator\": \"" << R.Allocator << "\""
+           << ", \"shape\": \"" << R.Shape << "\""
+           << ", \"dimension\": " << R.Dimension
+           << ", \"points\": " << R.Points
+           << ", \"operation\": \"" << R.Operation << "\""
+           << ", \"technique\": " << (R.Technique.empty() ? "null" : "\"" + R.Technique + "\"")
+           << ", \"traversal\": \"" << R.Traversal << "\""
+           << ", \"eps\": " << R.Eps
+           << ", \"min_pts\": " << R.MinPts
+           << ", \"seconds\": " << R.Seconds
+           << ", \"points_per_second\": " << ((0.0 < R.Seconds) ? (static_cast<double>(R.Points) / R.Seconds) : 0.0)
+           << ", \"allocations\": " << R.Allocations
+           << ", \"clusters\": " << R.Clusters
+           << ", \"noise\": " << R.Noise
+           << " }" << (((i + 1) == Results.size()) ? "" : ",") << "\n";
+    }
+    FO << "  ]\n"
+       << "}\n";
+    FO.close();
+    if(!FO) throw std::runtime_error("Unable to write benchmark results to '" + OutputFilename + "'.");
+
+    std::cerr << "Wrote " << Results.size() << " results to '" << OutputFilename << "'." << std::endl;
+    return 0;
+}
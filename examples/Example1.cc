@@ -120,26 +120,29 @@ int main(){
     
     }
 
-    //Stuff some testing data into the R*-tree.
-    rtree.insert(CDat_t( { -3.0, 0.0 }, {0.0f} ));
-    rtree.insert(CDat_t( { -2.8, 0.1 }, {1.0f} ));
-    rtree.insert(CDat_t( { -2.7, 0.2 }, {0.0f} ));
-    rtree.insert(CDat_t( { -2.5, 0.5 }, {0.0f} ));
-    rtree.insert(CDat_t( {  2.0, 0.2 }, {1.0f} ));
-    rtree.insert(CDat_t( {  2.1, 1.1 }, {1.0f} ));
-    rtree.insert(CDat_t( {  2.7, 1.5 }, {0.0f} ));
-    rtree.insert(CDat_t( {  6.7, 6.5 }, {0.0f} ));
-    rtree.insert(CDat_t( {  6.7, 7.5 }, {0.0f} ));
-    rtree.insert(CDat_t( {  7.7, 6.5 }, {0.0f} ));
-    rtree.insert(CDat_t( {  6.7, 5.5 }, {0.0f} ));
-    rtree.insert(CDat_t( {  5.7, 6.5 }, {0.0f} ));
-    //for(double x = -10'000.0 ; x < 10'000.0 ; x += 1.0) rtree.insert(CDat_t( {x,x}, {static_cast<float>(x)} ));
+    //Gather some testing data. The R*-tree is bulk-loaded afterward, which is faster than inserting one-by-one.
+    std::vector<CDat_t> data;
+    data.push_back(CDat_t( { -3.0, 0.0 }, {0.0f} ));
+    data.push_back(CDat_t( { -2.8, 0.1 }, {1.0f} ));
+    data.push_back(CDat_t( { -2.7, 0.2 }, {0.0f} ));
+    data.push_back(CDat_t( { -2.5, 0.5 }, {0.0f} ));
+    data.push_back(CDat_t( {  2.0, 0.2 }, {1.0f} ));
+    data.push_back(CDat_t( {  2.1, 1.1 }, {1.0f} ));
+    data.push_back(CDat_t( {  2.7, 1.5 }, {0.0f} ));
+    data.push_back(CDat_t( {  6.7, 6.5 }, {0.0f} ));
+    data.push_back(CDat_t( {  6.7, 7.5 }, {0.0f} ));
+    data.push_back(CDat_t( {  7.7, 6.5 }, {0.0f} ));
+    data.push_back(CDat_t( {  6.7, 5.5 }, {0.0f} ));
+    data.push_back(CDat_t( {  5.7, 6.5 }, {0.0f} ));
+    //for(double x = -10'000.0 ; x < 10'000.0 ; x += 1.0) data.push_back(CDat_t( {x,x}, {static_cast<float>(x)} ));
 
     //Stuff some more points in.
     size_t FixedSeed = 9137;
     std::mt19937 re(FixedSeed);
     std::uniform_real_distribution<> rd(-100.0, 100.0);
-    for(size_t i = 0; i < 1000; ++i) rtree.insert(CDat_t( { rd(re), rd(re) }, { rd(re) }));
+    for(size_t i = 0; i < 1000; ++i) data.push_back(CDat_t( { rd(re), rd(re) }, { rd(re) }));
+
+    rtree = BuildPackedRTree<RTree_t,CDat_t>(data);
 
 
     //const size_t MinPts = CDat_t::SpatialDimensionCount_*2;
@@ -106,14 +106,18 @@ int main(){
     
     }
 
-    //Stuff some testing data into the R*-tree.
-    for(double x = -1'000.0 ; x < 1'000.0 ; x += 1.0) rtree.insert(CDat_t( {x},{} ));
+    //Gather some testing data.
+    std::vector<CDat_t> data;
+    for(double x = -1'000.0 ; x < 1'000.0 ; x += 1.0) data.push_back(CDat_t( {x},{} ));
 
-    //Stuff some more points in.
+    //Gather some more points.
     size_t FixedSeed = 9137;
     std::mt19937 re(FixedSeed);
     std::uniform_real_distribution<> rd(0.0, 100'000.0);
-    for(size_t i = 0; i < 100'000; ++i) rtree.insert(CDat_t( { rd(re) }, { }));
+    for(size_t i = 0; i < 100'000; ++i) data.push_back(CDat_t( { rd(re) }, { }));
+
+    //Bulk-load the R*-tree.
+    rtree = BuildPackedRTree<RTree_t,CDat_t>(data);
 
 
     auto SortedkDistGraphData = DBSCANSortedkDistGraph<RTree_t,CDat_t>(rtree);
@@ -13,6 +13,7 @@
 #include <set>
 #include <random>
 #include <sstream>
+#include <chrono>
 
 #include "YgorClustering.hpp"
 //#include "YgorClusteringDatumCommonInstantiations.hpp"
@@ -25,22 +26,31 @@ int main(){
     typedef ClusteringDatum<1, double, 0, double, uint32_t, uint32_t> CDat_t;
     typedef boost::geometry::index::rtree<CDat_t,RTreeParameter_t> RTree_t;
 
-    RTree_t rtree;
-
     size_t FixedSeed = 9137;
     std::mt19937 re(FixedSeed);
     std::uniform_real_distribution<> rd(0.0, 1'000'000.0);
 
+    std::vector<CDat_t> data;
+    data.reserve(1'000'000);
     for(size_t i = 0; i < 1'000'000; ++i){
-        rtree.insert(CDat_t({ rd(re) }));
+        data.push_back(CDat_t({ rd(re) }));
     }
 
+    //Bulk-loading is much faster than inserting one-by-one, and results in a better-balanced tree.
+    RTree_t rtree = BuildPackedRTree<RTree_t,CDat_t>(data);
+    data.clear();
+
 
     //const size_t MinPts = CDat_t::SpatialDimensionCount_*2;
     //const SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin;
     const double Eps = 0.3;
     
+    const auto TimeBefore = std::chrono::steady_clock::now();
     DBSCAN<RTree_t,CDat_t>(rtree,Eps);
+    const auto TimeAfter = std::chrono::steady_clock::now();
+
+    std::cout << "DBSCAN took " << std::chrono::duration<double>(TimeAfter - TimeBefore).count() << " s"
+              << " for " << rtree.size() << " datum." << std::endl;
 
 /*
     //Print out the points with cluster info.
@@ -93,16 +93,16 @@ int main(int argc, char* argv[]){
     std::cout << "Considering the following files:" << std::endl;
     for(const auto &p : EnumeratedFiles) std::cout << "    " << p.string() << std::endl;
 
-    //Find a timestamp for each file. Attach the data to a ClusteringDatum_t and insert into a tree.
+    //Find a timestamp for each file. The paths are kept in a separate store so they are never copied into the tree.
     constexpr size_t MaxElementsInANode = 6; // 16, 32, 128, 256, ... ?
     typedef boost::geometry::index::rstar<MaxElementsInANode> RTreeParameter_t;
 
     //typedef std::pair<boost::filesystem::path, std::time_t> UserData_t;
     typedef boost::filesystem::path UserData_t;
-    typedef ClusteringDatum<1, double, 0, double, uint32_t, UserData_t> CDat_t;
-    typedef boost::geometry::index::rtree<CDat_t,RTreeParameter_t> RTree_t;
+    typedef ClusteringStore<1, double, 0, double, uint32_t, UserData_t> Store_t;
+    typedef boost::geometry::index::rtree<Store_t::Point_t,RTreeParameter_t> RTree_t;
 
-    RTree_t rtree;
+    Store_t store;
     uint64_t BeforeCount = 0;
 
     const std::time_t BaseTime = 0;
@@ -113,7 +113,7 @@ int main(int argc, char* argv[]){
             try{
                 const auto modtime = boost::filesystem::last_write_time(EnumeratedFile);
                 const auto timedelta = std::difftime(modtime,BaseTime);
-                rtree.insert(CDat_t({ timedelta }, { }, EnumeratedFile));
+                store.push_back({ timedelta }, { }, EnumeratedFile);
                 ++BeforeCount;
 
             }catch(const boost::filesystem::filesystem_error &){ }
@@ -122,34 +122,29 @@ int main(int argc, char* argv[]){
 
     std::cout << "Number of photos being considered: " << BeforeCount << std::endl;
 
+    const RTree_t rtree = BuildIndexedRTree<RTree_t>(store);
+
     const size_t MinPts = 3;
     const double Eps = 3600.0 * 12.0; //Seconds.
     
-    DBSCAN<RTree_t,CDat_t>(rtree,Eps,MinPts);
+    DBSCANIndexed<RTree_t,Store_t>(rtree,store,Eps,MinPts);
 
 
     //Print out the points with cluster info.
     if(false){
-        constexpr auto RTreeSpatialQueryGetAll = [](const CDat_t &) -> bool { return true; };
-        RTree_t::const_query_iterator it;
-        it = rtree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
-        for( ; it != rtree.qend(); ++it){
-            //std::cout << "  Point: " << boost::geometry::wkt(*it)
-            std::cout << "ClusterID: " << it->CID.ToText()
-                      << "\t\t Filename: " << it->UserData
+        for(size_t i = 0; i < store.size(); ++i){
+            std::cout << "ClusterID: " << store.CIDs[i].ToText()
+                      << "\t\t Filename: " << store.UserData[i]
                       << std::endl;
         }
     }
 
 
     //Segregate the data based on ClusterID.
-    std::map<uint32_t, std::list<CDat_t> > Segregated;
+    std::map<uint32_t, std::list<UserData_t> > Segregated;
     if(true){
-        constexpr auto RTreeSpatialQueryGetAll = [](const CDat_t &) -> bool { return true; };
-        RTree_t::const_query_iterator it;
-        it = rtree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
-        for( ; it != rtree.qend(); ++it){
-            Segregated[it->CID.Raw].push_back( *it );
+        for(size_t i = 0; i < store.size(); ++i){
+            Segregated[store.CIDs[i].Raw].push_back( store.UserData[i] );
         }
     }
 
@@ -167,18 +162,14 @@ int main(int argc, char* argv[]){
     const std::string base("/tmp/clusters/");
     boost::filesystem::create_directories(base);
 
-    const auto PredicateSortOnFilename = [](const CDat_t &L, const CDat_t &R) -> bool {
-        return (L.UserData < R.UserData);
-    };
-
     for(auto & Cluster : Segregated){
-        Cluster.second.sort(PredicateSortOnFilename);
+        Cluster.second.sort();
 
         const std::string cluster_FN = base + std::to_string(Cluster.first);
         std::cout << "    Writing cluster '" << cluster_FN << "'" << std::endl;
 
         std::ofstream FO(cluster_FN);
-        for(auto & FN : Cluster.second) FO << FN.UserData.native() << std::endl;
+        for(auto & FN : Cluster.second) FO << FN.native() << std::endl;
         FO.flush();
         FO.close();
     }
@@ -5,7 +5,7 @@ CXXFLAGS+=" -Wall -Wextra -Wpedantic -Warray-bounds -Wmaybe-uninitialized"
 CXXFLAGS+=" -fsanitize=address -fsanitize=undefined"
 
 g++ ${CXXFLAGS} Example1.cc -o example_1
-g++ ${CXXFLAGS} Example2.cc -o example_2
+g++ ${CXXFLAGS} -DYGORCLUSTERING_DEFINE_COMMON_INSTANTIATIONS Example2.cc -o example_2 # Or link against ygorclustering_common.
 g++ ${CXXFLAGS} Example3.cc -o example_3
 g++ ${CXXFLAGS} Example4.cc -o example_4 -lboost_date_time -lboost_filesystem -lboost_system
 
@@ -53,8 +53,10 @@ template <class T> class ClusterID {
         static const auto Cluster0 = std::numeric_limits<T>::min(); //Cluster1 = Cluster0 + 1, etc..
     
         constexpr ClusterID(void) : Raw(ClusterID<T>::Unclassified) { }
-        constexpr ClusterID(const ClusterID<T> &in) : Raw(in.Raw) { }
+        constexpr ClusterID(const ClusterID<T> &in) = default;
         constexpr ClusterID(T in) : Raw(in) { }
+
+        ClusterID<T> & operator=(const ClusterID<T> &rhs) = default;
    
         bool operator<(const ClusterID<T> &rhs) const {
             return (this->Raw < rhs.Raw);
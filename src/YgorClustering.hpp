@@ -50,8 +50,27 @@
 
 #include "YgorClusterID.hpp"
 #include "YgorClusteringDatum.hpp"
+#include "YgorClusteringFixedPoint.hpp"
+#include "YgorClusteringArena.hpp"
+#include "YgorClusteringSpaceFillingCurve.hpp"
+#include "YgorClusteringIndexed.hpp"
 #include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringStats.hpp"
+#include "YgorClusteringOptions.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringRadiusQuery.hpp"
+#include "YgorClusteringDBSCANGrid.hpp"
+#include "YgorClusteringDBSCAN1D.hpp"
 #include "YgorClusteringDBSCAN.hpp"
+#include "YgorClusteringDBSCANParallel.hpp"
+#include "YgorClusteringDBSCANSweep.hpp"
+#include "YgorClusteringDBSCANIncremental.hpp"
+#include "YgorClusteringDBSCANTiled.hpp"
+//#include "YgorClusteringBinaryIO.hpp" //Requires POSIX memory-mapping; include it explicitly.
+#include "YgorClusteringRTreeTuning.hpp"
+#include "YgorClusteringOPTICS.hpp"
+#include "YgorClusteringHDBSCAN.hpp"
 //#include "YgorClusteringDatumCommonInstantiations.hpp"
 
 
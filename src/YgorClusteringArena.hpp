@@ -0,0 +1,219 @@
+
+#ifndef YGOR_CLUSTERING_ARENA_HPP
+#define YGOR_CLUSTERING_ARENA_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+
+//This class is a memory arena for R*-tree nodes and clustering scratch buffers. Memory is carved sequentially out of
+// large chunks (which grow geometrically, up to MaxChunkBytes), so nodes created one after another (e.g., while
+// bulk-loading an R*-tree) are adjacent in memory, and a tree with millions of nodes needs only a few hundred heap
+// allocations. Freed blocks are kept on per-size free lists and recycled, which suits R*-trees well: all nodes of a
+// tree have the same handful of sizes, so nodes released while rebalancing are reused by the next split.
+//
+// Memory is only returned to the system when the arena is destroyed, which frees every chunk at once regardless of
+// how many blocks were carved from it.
+//
+// NOTE: Blocks larger than MaxPooledBytes, or with stricter alignment than std::max_align_t, are passed straight
+//       through to the global operator new.
+//
+// NOTE: Allocation and deallocation are serialized with a mutex, so an arena can be shared between threads (e.g.,
+//       by concurrent DBSCAN() runs on the same tree). The lock is uncontended in the common single-threaded case.
+//
+class ClusteringArena {
+    public:
+        static constexpr size_t Alignment = alignof(std::max_align_t);
+        static constexpr size_t MaxPooledBytes = 16 * 1024;
+        static constexpr size_t MinChunkBytes = 64 * 1024;
+        static constexpr size_t MaxChunkBytes = 16 * 1024 * 1024;
+
+    private:
+        std::mutex Lock;
+        std::vector<void *> Chunks;
+        unsigned char *Cursor = nullptr;
+        size_t Remaining = 0;
+        size_t NextChunkBytes = MinChunkBytes;
+        size_t Reserved = 0;
+
+        //Free lists, indexed by the block size in units of Alignment. The link is stored in the free block itself.
+        std::array<void *, (MaxPooledBytes / Alignment) + 1> FreeLists;
+
+        static size_t RoundUp(size_t Bytes){
+            return ((std::max<size_t>(Bytes, 1) + Alignment - 1) / Alignment) * Alignment;
+        }
+
+        static bool IsPooled(size_t Bytes, size_t Align){
+            return (Bytes <= MaxPooledBytes) && (Align <= Alignment);
+        }
+
+    public:
+        ClusteringArena(void){
+            this->FreeLists.fill(nullptr);
+        }
+
+        ClusteringArena(const ClusteringArena &) = delete;
+        ClusteringArena & operator=(const ClusteringArena &) = delete;
+
+        ~ClusteringArena(){
+            for(void *c : this->Chunks) ::operator delete(c);
+        }
+
+        void * Allocate(size_t Bytes, size_t Align){
+            if(!IsPooled(Bytes, Align)){
+                return (Align <= Alignment) ? ::operator new(Bytes)
+                                            : ::operator new(Bytes, std::align_val_t(Align));
+            }
+            const size_t Size = RoundUp(Bytes);
+            std::lock_guard<std::mutex> lock(this->Lock);
+
+            void *&Head = this->FreeLists[Size / Alignment];
+            if(Head != nullptr){
+                void *p = Head;
+                Head = *static_cast<void **>(p);
+                return p;
+            }
+
+            if(this->Remaining < Size){
+                //The tail of the current chunk is abandoned. It is always smaller than a pooled block.
+                const size_t ChunkBytes = this->NextChunkBytes;
+                this->Chunks.reserve(this->Chunks.size() + 1);
+                this->Cursor = static_cast<unsigned char *>(::operator new(ChunkBytes));
+                this->Chunks.push_back(this->Cursor);
+                this->Remaining = ChunkBytes;
+                this->Reserved += ChunkBytes;
+                this->NextChunkBytes = std::min(MaxChunkBytes, 2 * ChunkBytes);
+            }
+            void *p = this->Cursor;
+            this->Cursor += Size;
+            this->Remaining -= Size;
+            return p;
+        }
+
+        void Deallocate(void *p, size_t Bytes, size_t Align){
+            if(p == nullptr) return;
+            if(!IsPooled(Bytes, Align)){
+                if(Align <= Alignment){
+                    ::operator delete(p);
+                }else{
+                    ::operator delete(p, std::align_val_t(Align));
+                }
+                return;
+            }
+            const size_t Size = RoundUp(Bytes);
+            std::lock_guard<std::mutex> lock(this->Lock);
+            void *&Head = this->FreeLists[Size / Alignment];
+            *static_cast<void **>(p) = Head;
+            Head = p;
+            return;
+        }
+
+        //The number of bytes obtained from the system for pooled blocks, including free and abandoned space.
+        size_t BytesReserved(void){
+            std::lock_guard<std::mutex> lock(this->Lock);
+            return this->Reserved;
+        }
+};
+
+
+//This is a standard-conforming allocator that draws from a shared ClusteringArena. It can be supplied as the
+// allocator of a Boost.Geometry R*-tree, which rebinds it for its nodes, e.g.:
+//
+//     typedef boost::geometry::index::rtree< CDat_t,
+//                                            boost::geometry::index::rstar<16>,
+//                                            boost::geometry::index::indexable<CDat_t>,
+//                                            boost::geometry::index::equal_to<CDat_t>,
+//                                            ClusteringArenaAllocator<CDat_t> > RTree_t;
+//
+// A default-constructed allocator creates a new arena, so every R*-tree gets its own arena unless one is passed to
+// the tree's constructor explicitly. Copies (and rebound copies) share the arena, which lives until the last of them
+// is destroyed. Copying a tree gives the copy a new arena.
+//
+// DBSCAN() allocates its scratch buffers with (a rebound copy of) the R*-tree's allocator, so they are drawn from the
+// same arena.
+//
+template <typename T>
+class ClusteringArenaAllocator {
+    public:
+        typedef T value_type;
+        typedef std::true_type propagate_on_container_copy_assignment;
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+        typedef std::false_type is_always_equal;
+
+        std::shared_ptr<ClusteringArena> Arena;
+
+        ClusteringArenaAllocator(void) : Arena(std::make_shared<ClusteringArena>()) { }
+
+        explicit ClusteringArenaAllocator(std::shared_ptr<ClusteringArena> A) : Arena(std::move(A)) { }
+
+        //Note: there is deliberately no move constructor, so a moved-from allocator (e.g., of a moved-from tree)
+        //      still refers to a valid arena.
+        ClusteringArenaAllocator(const ClusteringArenaAllocator &rhs) : Arena(rhs.Arena) { }
+
+        template <typename U>
+        ClusteringArenaAllocator(const ClusteringArenaAllocator<U> &rhs) : Arena(rhs.Arena) { }
+
+        ClusteringArenaAllocator & operator=(const ClusteringArenaAllocator &rhs){
+            this->Arena = rhs.Arena;
+            return *this;
+        }
+
+        template <typename U>
+        struct rebind {
+            typedef ClusteringArenaAllocator<U> other;
+        };
+
+        T * allocate(size_t n){
+            if((std::numeric_limits<size_t>::max() / sizeof(T)) < n) throw std::bad_alloc();
+            return static_cast<T *>(this->Arena->Allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T *p, size_t n){
+            this->Arena->Deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+        ClusteringArenaAllocator select_on_container_copy_construction(void) const {
+            return ClusteringArenaAllocator();
+        }
+};
+
+template <typename T, typename U>
+bool operator==(const ClusteringArenaAllocator<T> &lhs, const ClusteringArenaAllocator<U> &rhs){
+    return (lhs.Arena == rhs.Arena);
+}
+
+template <typename T, typename U>
+bool operator!=(const ClusteringArenaAllocator<T> &lhs, const ClusteringArenaAllocator<U> &rhs){
+    return (lhs.Arena != rhs.Arena);
+}
+
+#endif //YGOR_CLUSTERING_ARENA_HPP
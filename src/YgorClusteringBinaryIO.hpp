@@ -0,0 +1,520 @@
+
+#ifndef YGOR_CLUSTERING_BINARYIO_HPP
+#define YGOR_CLUSTERING_BINARYIO_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+
+
+//This is a compact binary layout for ClusteringDatum datasets and cluster labels. It is meant to replace text
+// files when many millions of datum need to be passed between stages of a pipeline or reloaded after a crash.
+//
+// A file consists of a fixed 64-byte header followed by column-major arrays: each spatial coordinate column, then
+// each attribute column, then the ClusterID column (i.e., the ClusterID::Raw values). Every column holds exactly
+// DatumCount values and begins on a 64-byte boundary, so each column can be used in-place once memory-mapped.
+// Label-only files are simply files with no spatial or attribute columns.
+//
+// Types are recorded as a code (see ClusteringBinaryTypeCode()) so that a file is only ever interpreted with the
+// same types it was written with. Values are stored in native byte order, which is recorded in the header and
+// checked when reading; files are not meant to be portable between hosts of differing endianness.
+//
+// NOTE: Reading relies on POSIX memory-mapping, so this header is not part of YgorClustering.hpp and must be
+//       included explicitly.
+//
+struct ClusteringBinaryHeader {
+    char Magic[8];                    // "YGCLSTR" with a trailing nul.
+    uint32_t ByteOrderMark;           // 0x01020304 written in native byte order.
+    uint32_t Version;
+    uint32_t SpatialDimensionCount;
+    uint32_t SpatialTypeCode;
+    uint32_t AttributeDimensionCount;
+    uint32_t AttributeTypeCode;
+    uint32_t ClusterIDWidth;          // sizeof(ClusterIDType), or 0 if no ClusterID column is present.
+    uint32_t Reserved;
+    uint64_t DatumCount;
+    uint8_t Padding[16];
+};
+static_assert(sizeof(ClusteringBinaryHeader) == 64, "ClusteringBinaryHeader layout must be exactly 64 bytes.");
+
+constexpr uint32_t ClusteringBinaryByteOrderMark = 0x01020304;
+constexpr uint32_t ClusteringBinaryVersion = 1;
+constexpr uint64_t ClusteringBinaryColumnAlignment = 64;
+
+
+//Encodes an arithmetic type as (kind << 8) | sizeof(T), where kind is 1 for floating-point, 2 for signed
+// integers, and 3 for unsigned integers. Types with no columns (e.g., when a dimension count is zero) still get a
+// code, but it is not checked.
+template <typename T>
+constexpr uint32_t ClusteringBinaryTypeCode(void){
+    static_assert(std::is_arithmetic<T>::value, "Only arithmetic types can be stored in binary columns.");
+    return ( std::is_floating_point<T>::value ? 1u : (std::is_signed<T>::value ? 2u : 3u) ) << 8
+           | static_cast<uint32_t>(sizeof(T));
+}
+
+
+//Byte offsets of each column, given a header. Columns are ordered spatial, attribute, then ClusterID.
+// A std::runtime_error is thrown if the layout cannot be represented with 64-bit offsets (e.g., a corrupt header).
+inline std::vector<uint64_t> ClusteringBinaryColumnOffsets(const ClusteringBinaryHeader &H){
+    constexpr uint64_t Max = std::numeric_limits<uint64_t>::max();
+    const auto Overflow = [](void) -> void {
+        throw std::runtime_error("Binary clustering file layout overflows 64-bit offsets.");
+    };
+    const auto Align = [&](uint64_t x) -> uint64_t {
+        if((Max - x) < (ClusteringBinaryColumnAlignment - 1)) Overflow();
+        return ((x + ClusteringBinaryColumnAlignment - 1) / ClusteringBinaryColumnAlignment)
+               * ClusteringBinaryColumnAlignment;
+    };
+    std::vector<uint64_t> out;
+    uint64_t Offset = sizeof(ClusteringBinaryHeader);
+    const auto Push = [&](uint64_t Width) -> void {
+        out.push_back(Offset);
+        if((Width != 0) && ((Max / Width) < H.DatumCount)) Overflow();
+        const uint64_t Bytes = Width * H.DatumCount;
+        if((Max - Offset) < Bytes) Overflow();
+        Offset = Align(Offset + Bytes);
+    };
+    for(uint32_t d = 0; d < H.SpatialDimensionCount; ++d) Push(H.SpatialTypeCode & 0xFF);
+    for(uint32_t a = 0; a < H.AttributeDimensionCount; ++a) Push(H.AttributeTypeCode & 0xFF);
+    if(H.ClusterIDWidth != 0) Push(H.ClusterIDWidth);
+    out.push_back(Offset); //The total file size.
+    return out;
+}
+
+
+template < typename ClusteringDatum_t >
+ClusteringBinaryHeader ClusteringBinaryHeaderFor(uint64_t DatumCount, bool IncludeDatum = true){
+    ClusteringBinaryHeader H;
+    std::memset(&H, 0, sizeof(H));
+    std::memcpy(H.Magic, "YGCLSTR", 8);
+    H.ByteOrderMark = ClusteringBinaryByteOrderMark;
+    H.Version = ClusteringBinaryVersion;
+    H.SpatialDimensionCount = IncludeDatum ? static_cast<uint32_t>(ClusteringDatum_t::SpatialDimensionCount_) : 0;
+    H.SpatialTypeCode = ClusteringBinaryTypeCode<typename ClusteringDatum_t::SpatialType_>();
+    H.AttributeDimensionCount = IncludeDatum ? static_cast<uint32_t>(ClusteringDatum_t::AttributeDimensionCount_) : 0;
+    H.AttributeTypeCode = ClusteringBinaryTypeCode<typename ClusteringDatum_t::AttributeType_>();
+    H.ClusterIDWidth = static_cast<uint32_t>(sizeof(typename ClusteringDatum_t::ClusterIDType_));
+    H.DatumCount = DatumCount;
+    return H;
+}
+
+
+//This class writes column-major files in a single pass. Values are staged in per-column buffers and flushed to
+// each column's final position whenever the buffers fill, so the input never needs to be traversed more than
+// once and memory usage is bounded regardless of how many datum are written.
+template < typename ClusteringDatum_t >
+class ClusteringBinaryWriter {
+    public:
+        typedef typename ClusteringDatum_t::SpatialType_ SpatialType_;
+        typedef typename ClusteringDatum_t::AttributeType_ AttributeType_;
+        typedef typename ClusteringDatum_t::ClusterIDType_ ClusterIDType_;
+
+    private:
+        constexpr static size_t ChunkSize = 1 << 16;
+
+        std::ofstream FO;
+        ClusteringBinaryHeader Header;
+        std::vector<uint64_t> Offsets;
+        uint64_t Written = 0;
+        uint64_t Staged = 0;
+
+        std::vector<std::vector<SpatialType_>> SpatialColumns;
+        std::vector<std::vector<AttributeType_>> AttributeColumns;
+        std::vector<ClusterIDType_> CIDColumn;
+
+        template <typename T>
+        void FlushColumn(size_t Column, const std::vector<T> &Buffer){
+            this->FO.seekp(static_cast<std::streamoff>(this->Offsets[Column] + this->Written * sizeof(T)));
+            this->FO.write(reinterpret_cast<const char *>(Buffer.data()),
+                           static_cast<std::streamsize>(this->Staged * sizeof(T)));
+        }
+
+        void Flush(void){
+            if(this->Staged == 0) return;
+            size_t Column = 0;
+            for(const auto &c : this->SpatialColumns) this->FlushColumn(Column++, c);
+            for(const auto &c : this->AttributeColumns) this->FlushColumn(Column++, c);
+            if(this->Header.ClusterIDWidth != 0) this->FlushColumn(Column++, this->CIDColumn);
+            if(!this->FO) throw std::runtime_error("Unable to write binary clustering file.");
+            this->Written += this->Staged;
+            this->Staged = 0;
+        }
+
+    public:
+        ClusteringBinaryWriter(const std::string &Filename, uint64_t DatumCount, bool IncludeDatum = true)
+            : FO(Filename, std::ios::binary | std::ios::trunc),
+              Header(ClusteringBinaryHeaderFor<ClusteringDatum_t>(DatumCount, IncludeDatum)) {
+            if(!this->FO) throw std::runtime_error("Unable to open binary clustering file for writing.");
+            this->Offsets = ClusteringBinaryColumnOffsets(this->Header);
+            this->SpatialColumns.resize(this->Header.SpatialDimensionCount, std::vector<SpatialType_>(ChunkSize));
+            this->AttributeColumns.resize(this->Header.AttributeDimensionCount, std::vector<AttributeType_>(ChunkSize));
+            this->CIDColumn.resize(ChunkSize);
+
+            this->FO.write(reinterpret_cast<const char *>(&this->Header), sizeof(this->Header));
+        }
+
+        void Append(const ClusteringDatum_t &D){
+            this->Append(D, D.CID);
+        }
+
+        //Appends a datum, but records the provided ClusterID instead of the datum's own.
+        void Append(const ClusteringDatum_t &D, const ClusterID<ClusterIDType_> &CID){
+            if((this->Written + this->Staged) == this->Header.DatumCount){
+                throw std::runtime_error("Attempted to write more datum than declared.");
+            }
+            for(size_t d = 0; d < this->SpatialColumns.size(); ++d) this->SpatialColumns[d][this->Staged] = D.Coordinates[d];
+            for(size_t a = 0; a < this->AttributeColumns.size(); ++a) this->AttributeColumns[a][this->Staged] = D.Attributes[a];
+            this->CIDColumn[this->Staged] = CID.Raw;
+            if(++(this->Staged) == ChunkSize) this->Flush();
+        }
+
+        //Appends a label to a label-only file.
+        void Append(const ClusterID<ClusterIDType_> &CID){
+            if((this->Written + this->Staged) == this->Header.DatumCount){
+                throw std::runtime_error("Attempted to write more labels than declared.");
+            }
+            this->CIDColumn[this->Staged] = CID.Raw;
+            if(++(this->Staged) == ChunkSize) this->Flush();
+        }
+
+        //Flushes remaining values and pads the file out to its full length. Must be called exactly once.
+        void Close(void){
+            this->Flush();
+            if(this->Written != this->Header.DatumCount){
+                throw std::runtime_error("Fewer datum were written than declared.");
+            }
+            const uint64_t Size = this->Offsets.back();
+            this->FO.seekp(0, std::ios::end);
+            const auto End = static_cast<uint64_t>(this->FO.tellp());
+            for(uint64_t i = End; i < Size; ++i) this->FO.put('\0');
+            this->FO.close();
+            if(!this->FO) throw std::runtime_error("Unable to finish writing binary clustering file.");
+        }
+};
+
+
+//Writes a dataset (coordinates, attributes, and ClusterIDs) from any range of datum.
+template < typename ClusteringDatum_t,
+           typename ForwardIterator_t >
+void WriteClusteringBinary( const std::string &Filename,
+                            ForwardIterator_t First,
+                            ForwardIterator_t Last ){
+    ClusteringBinaryWriter<ClusteringDatum_t> W(Filename, static_cast<uint64_t>(std::distance(First, Last)));
+    for( ; First != Last; ++First) W.Append(*First);
+    W.Close();
+    return;
+}
+
+template < typename ClusteringDatum_t >
+void WriteClusteringBinary( const std::string &Filename,
+                            const std::vector<ClusteringDatum_t> &Datum ){
+    WriteClusteringBinary<ClusteringDatum_t>(Filename, Datum.begin(), Datum.end());
+    return;
+}
+
+//Writes every datum in an R*-tree, in R*-tree traversal order.
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t >
+void WriteClusteringBinary( const std::string &Filename,
+                            RTree_t &RTree ){
+    ClusteringBinaryWriter<ClusteringDatum_t> W(Filename, static_cast<uint64_t>(RTree.size()));
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&](const typename RTree_t::const_query_iterator &it) -> void {
+        W.Append(*it);
+    });
+    W.Close();
+    return;
+}
+
+
+//Writes a label-only file from labels produced by, e.g., the const overloads of DBSCAN() or HDBSCAN().
+template < typename ClusteringDatum_t >
+void WriteClusterIDsBinary( const std::string &Filename,
+                            const std::vector<ClusterID<typename ClusteringDatum_t::ClusterIDType_>> &Labels ){
+    ClusteringBinaryWriter<ClusteringDatum_t> W(Filename, static_cast<uint64_t>(Labels.size()), false);
+    for(const auto &CID : Labels) W.Append(CID);
+    W.Close();
+    return;
+}
+
+//Writes a label-only file holding the ClusterIDs of an R*-tree, in R*-tree traversal order.
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t >
+void WriteClusterIDsBinary( const std::string &Filename,
+                            RTree_t &RTree ){
+    ClusteringBinaryWriter<ClusteringDatum_t> W(Filename, static_cast<uint64_t>(RTree.size()), false);
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&](const typename RTree_t::const_query_iterator &it) -> void {
+        W.Append(it->CID);
+    });
+    W.Close();
+    return;
+}
+
+
+//This class memory-maps a binary clustering file for reading. Columns are exposed directly as pointers into the
+// mapping, and datum are assembled on-the-fly by a random-access iterator, so the packing R*-tree constructor (see
+// BuildPackedRTree()) can be fed straight from the file without staging an intermediate copy of the dataset.
+//
+// The file is validated against ClusteringDatum_t when opened: dimension counts must match (unless the file is a
+// label-only file), all type codes and the ClusterID width must match, and the file must be long enough to hold
+// every column. A std::runtime_error is thrown otherwise.
+//
+// NOTE: The mapping is read-only and shared, so pages are loaded lazily by the OS and are shared with the page
+//       cache. Reloading a recently written file is therefore limited mostly by R*-tree construction.
+//
+// NOTE: Datum produced by this class have default-constructed UserData, which is not stored.
+//
+template < typename ClusteringDatum_t >
+class MappedClusteringBinary {
+    public:
+        typedef typename ClusteringDatum_t::SpatialType_ SpatialType_;
+        typedef typename ClusteringDatum_t::AttributeType_ AttributeType_;
+        typedef typename ClusteringDatum_t::ClusterIDType_ ClusterIDType_;
+
+    private:
+        void *Mapping = nullptr;
+        size_t MappingSize = 0;
+        ClusteringBinaryHeader Header;
+        std::vector<const SpatialType_ *> SpatialColumns;
+        std::vector<const AttributeType_ *> AttributeColumns;
+        const ClusterIDType_ *CIDColumn = nullptr;
+
+        void Unmap(void){
+            if(this->Mapping != nullptr) munmap(this->Mapping, this->MappingSize);
+            this->Mapping = nullptr;
+            this->MappingSize = 0;
+        }
+
+    public:
+        explicit MappedClusteringBinary(const std::string &Filename){
+            const int fd = open(Filename.c_str(), O_RDONLY);
+            if(fd < 0) throw std::runtime_error("Unable to open binary clustering file '" + Filename + "'.");
+
+            struct stat Info;
+            if( (fstat(fd, &Info) != 0)
+            ||  (static_cast<uint64_t>(Info.st_size) < sizeof(ClusteringBinaryHeader)) ){
+                close(fd);
+                throw std::runtime_error("Binary clustering file is too short to contain a header.");
+            }
+            this->MappingSize = static_cast<size_t>(Info.st_size);
+            this->Mapping = mmap(nullptr, this->MappingSize, PROT_READ, MAP_SHARED, fd, 0);
+            close(fd);
+            if(this->Mapping == MAP_FAILED){
+                this->Mapping = nullptr;
+                throw std::runtime_error("Unable to memory-map binary clustering file.");
+            }
+
+            try{
+                std::memcpy(&this->Header, this->Mapping, sizeof(this->Header));
+                const auto &H = this->Header;
+                if(std::memcmp(H.Magic, "YGCLSTR", 8) != 0){
+                    throw std::runtime_error("File is not a binary clustering file.");
+                }
+                if(H.ByteOrderMark != ClusteringBinaryByteOrderMark){
+                    throw std::runtime_error("Binary clustering file was written with a different byte order.");
+                }
+                if(H.Version != ClusteringBinaryVersion){
+                    throw std::runtime_error("Binary clustering file version is not supported.");
+                }
+                const bool LabelsOnly = (H.SpatialDimensionCount == 0) && (H.AttributeDimensionCount == 0);
+                if( !LabelsOnly
+                &&  ( (H.SpatialDimensionCount != ClusteringDatum_t::SpatialDimensionCount_)
+                   || (H.AttributeDimensionCount != ClusteringDatum_t::AttributeDimensionCount_) ) ){
+                    throw std::runtime_error("Binary clustering file dimensions do not match the datum type.");
+                }
+                if( ( (H.SpatialDimensionCount != 0)
+                   && (H.SpatialTypeCode != ClusteringBinaryTypeCode<SpatialType_>()) )
+                ||  ( (H.AttributeDimensionCount != 0)
+                   && (H.AttributeTypeCode != ClusteringBinaryTypeCode<AttributeType_>()) )
+                ||  ( (H.ClusterIDWidth != 0)
+                   && (H.ClusterIDWidth != sizeof(ClusterIDType_)) ) ){
+                    throw std::runtime_error("Binary clustering file types do not match the datum type.");
+                }
+
+                //Every column must individually fit in the mapping. This rejects absurd datum counts from a corrupt
+                // header before any offsets are computed.
+                const uint64_t Available = static_cast<uint64_t>(this->MappingSize) - sizeof(ClusteringBinaryHeader);
+                const auto CheckColumn = [&](uint64_t Width) -> void {
+                    if((Available / Width) < H.DatumCount){
+                        throw std::runtime_error("Binary clustering file is truncated.");
+                    }
+                };
+                if(H.SpatialDimensionCount != 0) CheckColumn(sizeof(SpatialType_));
+                if(H.AttributeDimensionCount != 0) CheckColumn(sizeof(AttributeType_));
+                if(H.ClusterIDWidth != 0) CheckColumn(sizeof(ClusterIDType_));
+
+                const auto Offsets = ClusteringBinaryColumnOffsets(H);
+                if(this->MappingSize < Offsets.back()){
+                    throw std::runtime_error("Binary clustering file is truncated.");
+                }
+                const char *Base = static_cast<const char *>(this->Mapping);
+                size_t Column = 0;
+                for(uint32_t d = 0; d < H.SpatialDimensionCount; ++d){
+                    this->SpatialColumns.push_back(reinterpret_cast<const SpatialType_ *>(Base + Offsets[Column++]));
+                }
+                for(uint32_t a = 0; a < H.AttributeDimensionCount; ++a){
+                    this->AttributeColumns.push_back(reinterpret_cast<const AttributeType_ *>(Base + Offsets[Column++]));
+                }
+                if(H.ClusterIDWidth != 0){
+                    this->CIDColumn = reinterpret_cast<const ClusterIDType_ *>(Base + Offsets[Column++]);
+                }
+            }catch(const std::exception &){
+                this->Unmap();
+                throw;
+            }
+        }
+
+        MappedClusteringBinary(const MappedClusteringBinary &) = delete;
+        MappedClusteringBinary & operator=(const MappedClusteringBinary &) = delete;
+
+        ~MappedClusteringBinary(){
+            this->Unmap();
+        }
+
+        size_t size(void) const {
+            return static_cast<size_t>(this->Header.DatumCount);
+        }
+
+        bool HasDatum(void) const {
+            return !this->SpatialColumns.empty();
+        }
+
+        bool HasClusterIDs(void) const {
+            return (this->CIDColumn != nullptr);
+        }
+
+        //Direct column access. Column d holds coordinate d of every datum.
+        const SpatialType_ * Coordinates(size_t d) const {
+            return this->SpatialColumns.at(d);
+        }
+
+        const AttributeType_ * Attributes(size_t a) const {
+            return this->AttributeColumns.at(a);
+        }
+
+        const ClusterIDType_ * ClusterIDs(void) const {
+            return this->CIDColumn;
+        }
+
+        ClusterID<ClusterIDType_> CID(size_t i) const {
+            return (this->CIDColumn == nullptr) ? ClusterID<ClusterIDType_>()
+                                                : ClusterID<ClusterIDType_>(this->CIDColumn[i]);
+        }
+
+        ClusteringDatum_t Datum(size_t i) const {
+            ClusteringDatum_t out;
+            for(size_t d = 0; d < this->SpatialColumns.size(); ++d) out.Coordinates[d] = this->SpatialColumns[d][i];
+            for(size_t a = 0; a < this->AttributeColumns.size(); ++a) out.Attributes[a] = this->AttributeColumns[a][i];
+            out.CID = this->CID(i);
+            return out;
+        }
+
+        //A random-access iterator that assembles datum by value.
+        class const_iterator {
+            public:
+                typedef std::random_access_iterator_tag iterator_category;
+                typedef ClusteringDatum_t value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const ClusteringDatum_t * pointer;
+                typedef ClusteringDatum_t reference;
+
+            private:
+                const MappedClusteringBinary *Parent = nullptr;
+                std::ptrdiff_t i = 0;
+
+            public:
+                const_iterator() = default;
+                const_iterator(const MappedClusteringBinary *P, std::ptrdiff_t I) : Parent(P), i(I) { }
+
+                reference operator*(void) const { return this->Parent->Datum(static_cast<size_t>(this->i)); }
+                reference operator[](difference_type n) const { return *(*this + n); }
+
+                const_iterator & operator++(void){ ++(this->i); return *this; }
+                const_iterator & operator--(void){ --(this->i); return *this; }
+                const_iterator operator++(int){ auto t = *this; ++(this->i); return t; }
+                const_iterator operator--(int){ auto t = *this; --(this->i); return t; }
+                const_iterator & operator+=(difference_type n){ this->i += n; return *this; }
+                const_iterator & operator-=(difference_type n){ this->i -= n; return *this; }
+                const_iterator operator+(difference_type n) const { return const_iterator(this->Parent, this->i + n); }
+                const_iterator operator-(difference_type n) const { return const_iterator(this->Parent, this->i - n); }
+                difference_type operator-(const const_iterator &rhs) const { return this->i - rhs.i; }
+
+                bool operator==(const const_iterator &rhs) const { return this->i == rhs.i; }
+                bool operator!=(const const_iterator &rhs) const { return this->i != rhs.i; }
+                bool operator<(const const_iterator &rhs) const { return this->i < rhs.i; }
+                bool operator>(const const_iterator &rhs) const { return this->i > rhs.i; }
+                bool operator<=(const const_iterator &rhs) const { return this->i <= rhs.i; }
+                bool operator>=(const const_iterator &rhs) const { return this->i >= rhs.i; }
+        };
+
+        const_iterator begin(void) const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end(void) const {
+            return const_iterator(this, static_cast<std::ptrdiff_t>(this->size()));
+        }
+};
+
+
+//Reloads a dataset file directly into a packed R*-tree. ClusterIDs are restored if present, so this can be used
+// to resume from a tree previously written with WriteClusteringBinary().
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t >
+RTree_t ReadClusteringBinaryRTree( const std::string &Filename,
+                                   typename RTree_t::parameters_type Parameters = typename RTree_t::parameters_type() ){
+    const MappedClusteringBinary<ClusteringDatum_t> File(Filename);
+    if(!File.HasDatum()) throw std::runtime_error("Binary clustering file contains only labels.");
+    return BuildPackedRTree<RTree_t, ClusteringDatum_t>(File.begin(), File.end(), Parameters);
+}
+
+
+//Reads a label-only (or dataset) file's ClusterIDs.
+template < typename ClusteringDatum_t >
+std::vector<ClusterID<typename ClusteringDatum_t::ClusterIDType_>> ReadClusterIDsBinary( const std::string &Filename ){
+    const MappedClusteringBinary<ClusteringDatum_t> File(Filename);
+    if(!File.HasClusterIDs()) throw std::runtime_error("Binary clustering file contains no ClusterIDs.");
+    const auto *Raw = File.ClusterIDs();
+    return std::vector<ClusterID<typename ClusteringDatum_t::ClusterIDType_>>(Raw, Raw + File.size());
+}
+
+#endif //YGOR_CLUSTERING_BINARYIO_HPP
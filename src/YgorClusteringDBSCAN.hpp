@@ -35,9 +35,13 @@
 #include <string>
 #include <complex>
 #include <set>
-#include <list>
 #include <random>
 #include <sstream>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <type_traits>
+#include <cmath>
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/point.hpp>
@@ -49,14 +53,113 @@
 #include <boost/geometry/algorithms/within.hpp>
 #include <boost/geometry/io/svg/svg_mapper.hpp>
 
+#include <boost/iterator/function_output_iterator.hpp>
 
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringStats.hpp"
+#include "YgorClusteringOptions.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringRadiusQuery.hpp"
+#include "YgorClusteringDBSCANGrid.hpp"
+#include "YgorClusteringDBSCAN1D.hpp"
+
+
+
+
+//This helper function finds the distance from a datum to its Count-th nearest datum in the R*-tree (counting the
+// datum itself, if it is a member of the tree). The number of datum found is returned; if it is less than Count,
+// the tree holds too few datum and Distance is the distance to the furthest datum.
+//
+// Only read access to the tree is required, so it is safe to call concurrently from multiple threads.
+//
+// NOTE: The R*-tree orders neighbours by Euclidean distance. For other metrics the Euclidean-nearest datum only
+//       bound the answer, and a second (box) query is used to find the exact distance.
+//
+// If Stats is provided, the queries and the datum they return are counted. See ClusteringStats.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+size_t NearestNeighbourDistance( const RTree_t & RTree,
+                                 const ClusteringDatum_t & P,
+                                 size_t Count,
+                                 typename ClusteringDatum_t::DistanceType_ & Distance,
+                                 ClusteringStats *Stats = nullptr ){
+    typedef typename ClusteringDatum_t::DistanceType_ T;
+    typedef typename ClusteringDatum_t::SpatialType_ S;
+    constexpr bool IsEuclidean = std::is_same<DistanceMetric_t, EuclideanDistanceMetric>::value;
+
+    size_t Found = 0;
+    T Furthest = 0; //Comparable distance.
+    auto Recorder = [&](const ClusteringDatum_t &nearby) -> void {
+        ++Found;
+        Furthest = std::max<T>(Furthest, MetricComparableDistance<DistanceMetric_t>(P, nearby));
+        return;
+    };
+    RTree.query( boost::geometry::index::nearest( P, static_cast<unsigned>(Count) ),
+                 boost::make_function_output_iterator(Recorder) );
+    if(Stats != nullptr){
+        Stats->RangeQueries += 1;
+        Stats->CandidatesReturned += Found;
+        Stats->CandidatesAccepted += Found;
+    }
+
+    if constexpr (!IsEuclidean){
+        if((0 < Found) && (Found == Count)){
+            //All datum within the bound are re-examined to find the true distance. The box is widened slightly so
+            // datum lying exactly on the bound are not lost to round-off. Integer coordinates are rounded outward.
+            const T Bound = DistanceMetric_t::FromComparable(Furthest);
+            ClusteringDatum_t Min(P), Max(P);
+            for(size_t d = 0; d < ClusteringDatum_t::SpatialDimensionCount_; ++d){
+                const T x = static_cast<T>(P.Coordinates[d]);
+                const T Slack = (std::abs(x) + Bound) * static_cast<T>(4) * std::numeric_limits<T>::epsilon();
+                if constexpr (std::is_integral<S>::value){
+                    Min.Coordinates[d] = static_cast<S>(std::floor(x - (Bound + Slack)));
+                    Max.Coordinates[d] = static_cast<S>(std::ceil(x + (Bound + Slack)));
+                }else{
+                    Min.Coordinates[d] = static_cast<S>(x - (Bound + Slack));
+                    Max.Coordinates[d] = static_cast<S>(x + (Bound + Slack));
+                }
+            }
+            const boost::geometry::model::box<ClusteringDatum_t> BBox(Min, Max);
+
+            std::vector<T> Distances;
+            Distances.reserve(2 * Count);
+            size_t Returned = 0;
+            auto Collector = [&](const ClusteringDatum_t &nearby) -> void {
+                ++Returned;
+                const T c = MetricComparableDistance<DistanceMetric_t>(P, nearby);
+                if(!(Furthest < c)) Distances.push_back(c);
+                return;
+            };
+            RTree.query( boost::geometry::index::covered_by( BBox ),
+                         boost::make_function_output_iterator(Collector) );
+            if(Stats != nullptr){
+                Stats->RangeQueries += 1;
+                Stats->CandidatesReturned += Returned;
+                Stats->CandidatesAccepted += Distances.size();
+            }
+            if(Distances.size() < Count){
+                throw std::runtime_error("Box query missed datum found by the nearest-neighbour query.");
+            }
+            std::nth_element(Distances.begin(), Distances.begin() + (Count - 1), Distances.end());
+            Furthest = Distances[Count - 1];
+        }
+    }
+    Distance = DistanceMetric_t::FromComparable(Furthest);
+    return Found;
+}
 
 
 template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
-           typename ClusteringDatum_t >
-std::vector<typename ClusteringDatum_t::SpatialType_> 
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+std::vector<typename ClusteringDatum_t::DistanceType_> 
     DBSCANSortedkDistGraph( RTree_t & RTree,
-                            size_t k = ClusteringDatum_t::SpatialDimensionCount_ * 2 ){
+                            size_t k = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                            size_t ThreadCount = DefaultClusteringThreadCount(),
+                            const DBSCANOptions *Options = nullptr,
+                            ClusteringStats *Stats = nullptr ){
     // This routine is a companion routine for the DBSCAN implementation provided below. It is from
     //   the same article as the DBSCAN algorithm and provides a means for the user to determine an
     //   appropriate DBSCAN Eps parameter.
@@ -81,50 +184,84 @@ std::vector<typename ClusteringDatum_t::SpatialType_>
     // 1. RTree --> The R*-tree already loaded with the data to be clustered.
     // 2. k --> DBSCAN algorithm parameter MinPts (up to around 4 in the 2D case -- play around with
     //          different values.
+    // 3. ThreadCount --> The number of threads to use, including the calling thread. The R*-tree is
+    //                    only read, so queries are performed concurrently.
+    // 4. Options --> If provided, progress is reported and cancellation is honoured, as for DBSCAN(). Progress
+    //                counts the datum whose k-distance has been computed as classified; no clusters are reported.
+    //                The traversal order is ignored. See DBSCANOptions.
+    // 5. Stats --> If provided, the nearest-neighbour queries and wall time per phase are recorded. See
+    //              ClusteringStats.
+    //
+    // The distance metric can be changed via the DistanceMetric_t template parameter. It should match the metric
+    //   used with DBSCAN().
     //
     // NOTE: No clustering will be performed in this routine. 
+    //
+    // NOTE: Each datum requires a bounded k+1 nearest-neighbour query (the self point is included),
+    //       so the cost grows only mildly with k. For non-Euclidean metrics the R*-tree's nearest-neighbour
+    //       ordering is only used to bound the search, and a second (box) query is needed per datum.
 
     if(k == 0) throw std::runtime_error("Parameter 'k' must be >= 1.");
 
-    std::vector<typename ClusteringDatum_t::SpatialType_> out;
-    out.reserve(RTree.size());
-
-    //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
-    constexpr auto RTreeSpatialQueryGetAll = [](const ClusteringDatum_t &) -> bool { return true; };
-
     const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
                                             " This point is missing, indicating numerical stability issues"
                                             " or logical errors in the spatial indexing approach.";
     const std::string ThrowkTooLarge = "Parameter 'k' was chosen too large. There are not enough nearest-"
                                        "neighbours to permit this computation!";
 
-    typename RTree_t::const_query_iterator outer_it;
-    outer_it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
-double dummy = 0.0;
-    for( ; outer_it != RTree.qend(); ++outer_it){
-dummy += 1.0;
-const auto percent = static_cast<double>( static_cast<intmax_t>(10000.0*dummy/RTree.size())/100.0 );
-std::cout << "  --> On datum " << dummy << " / " << RTree.size() << " = " << percent << "%" << std::endl;
-
-        //Query for nearby items ("seeds") within a distance Eps from the current point "*outer_it".
-        typename RTree_t::const_query_iterator nearby_it;
-        nearby_it = RTree.qbegin( boost::geometry::index::nearest( *outer_it, RTree.size() ) );
-        if(nearby_it == RTree.qend()) throw std::runtime_error(ThrowSelfPointCheck);
- 
-        size_t j = 0; //Start at zero because the self-point is included.
-        for(;;){ // Better to just use std::advance? (Can we detect not-enough-points that way?)
-            if(nearby_it == RTree.qend()) throw std::runtime_error(ThrowkTooLarge);
-            if(j == k){
-                out.push_back(boost::geometry::distance(*outer_it, *nearby_it));
-                break;
+    const RTree_t &ConstRTree = RTree;
+    std::vector<const ClusteringDatum_t *> Datum;
+    Datum.reserve(ConstRTree.size());
+    {
+        //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
+        constexpr auto RTreeSpatialQueryGetAll = [](const ClusteringDatum_t &) -> bool { return true; };
+        typename RTree_t::const_query_iterator it;
+        it = ConstRTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
+        for( ; it != ConstRTree.qend(); ++it) Datum.push_back( std::addressof(*it) );
+    }
+    const size_t N = Datum.size();
+    std::vector<typename ClusteringDatum_t::DistanceType_> out(N);
+
+    ClusteringProgressMonitor Monitor(Options, N);
+    Monitor.ThrowIfCancelled();
+    std::atomic<size_t> Completed(0);
+
+    typedef typename ClusteringDatum_t::DistanceType_ T;
+
+    //When instrumented, each chunk of datum is counted separately and merged once, so the threads do not contend.
+    ClusteringStatsPhaseTimer QueryTimer(Stats, "nearest-neighbour queries");
+    const size_t StatsChunkSize = 4096;
+    std::mutex StatsLock;
+    auto QueryChunk = [&](size_t c) -> void {
+        ClusteringStats Local;
+        ClusteringStats *LocalStats = (Stats == nullptr) ? nullptr : &Local;
+        const size_t End = std::min(N, (c + 1) * StatsChunkSize);
+        for(size_t i = c * StatsChunkSize; i < End; ++i){
+            //The (k+1)-nearest datum include the self point, so the k-distance is the largest of the distances.
+            T kDist = 0;
+            const size_t Found = NearestNeighbourDistance<RTree_t, ClusteringDatum_t, DistanceMetric_t>(
+                                     ConstRTree, *(Datum[i]), k + 1, kDist, LocalStats);
+            if(Found == 0) throw std::runtime_error(ThrowSelfPointCheck);
+            if(Found < (k + 1)) throw std::runtime_error(ThrowkTooLarge);
+            out[i] = kDist;
+            if(Monitor.IsActive()){
+                const size_t Done = Completed.fetch_add(1, std::memory_order_relaxed) + 1;
+                Monitor.Checkpoint(Done, Done, 0);
             }
-            ++nearby_it;
-            ++j;
         }
-    }                
+        if(LocalStats != nullptr){
+            std::lock_guard<std::mutex> lock(StatsLock);
+            Stats->MergeCounters(Local);
+        }
+    };
+    ParallelForEachIndex((N + StatsChunkSize - 1) / StatsChunkSize, ThreadCount, QueryChunk, 1);
+    QueryTimer.Stop();
 
     //Sort the data so the largest values occur first.
-    std::sort(out.begin(), out.end(), std::greater<typename ClusteringDatum_t::SpatialType_>());
+    ClusteringStatsPhaseTimer SortTimer(Stats, "sort");
+    ParallelSort(out.begin(), out.end(), std::greater<typename ClusteringDatum_t::DistanceType_>(), ThreadCount);
+    SortTimer.Stop();
+    Monitor.Finish(N, 0);
     return out;
 }
 
@@ -132,16 +269,364 @@ std::cout << "  --> On datum " << dummy << " / " << RTree.size() << " = " << per
 
 enum SpatialQueryTechnique {
     UseNearby,
-    UseWithin
+    UseWithin,
+    UseRadius,  //Hyper-sphere query that prunes R*-tree nodes by their distance to the query datum. See RadiusQueryVisitor.
+    UseGrid     //Whole-run technique: bins datum into a uniform grid instead of querying the R*-tree. See DBSCANGrid().
 };
 
 
+//This helper function applies a user function to each datum in the R*-tree that is strictly closer than Eps to the
+// query datum. The query datum itself is included if it is a member of the tree. Only read access to the tree is
+// required, so it is safe to call concurrently from multiple threads as long as nobody modifies the tree.
+//
+// User functions should be of the sort:
+//     std::function<void(const ClusteringDatum_t &)>;
+// and will receive references to the datum stored inside the R*-tree.
+//
+// Distances are measured with the given metric policy (see YgorClusteringMetrics.hpp). Candidates from the
+// bounding-box query are filtered in small blocks using comparable (e.g., squared) distances.
+//
+// The optional CandidateOp functor is invoked (with no arguments) once for every candidate the spatial index
+// returns, before distance filtering. It is used for instrumentation; see ClusteringStats.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename DatumOperation_t,
+           typename CandidateOperation_t >
+void OnEachDatumWithinEps( const RTree_t & RTree,
+                           const ClusteringDatum_t & Query,
+                           typename ClusteringDatum_t::DistanceType_ Eps,
+                           SpatialQueryTechnique UsersSpatialQueryTechnique,
+                           DatumOperation_t OpFunc,
+                           CandidateOperation_t CandidateOp ){
+
+    typedef typename ClusteringDatum_t::SpatialType_ S;
+    const auto ComparableEps = DistanceMetric_t::ToComparable(Eps);
+
+    if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseNearby){
+        //Datum are visited in order of increasing Euclidean distance, so stop once no datum can be within Eps.
+        const auto Reach = DistanceMetric_t::template EuclideanReach<ClusteringDatum_t::SpatialDimensionCount_>(Eps);
+        const auto ComparableReach = Reach * Reach;
+        typename RTree_t::const_query_iterator nearby_it;
+        nearby_it = RTree.qbegin( boost::geometry::index::nearest( Query, RTree.size() ) );
+        for( ; nearby_it != RTree.qend(); ++nearby_it){
+            if(boost::geometry::comparable_distance(Query, *nearby_it) < ComparableReach){
+                CandidateOp();
+                if(MetricComparableDistance<DistanceMetric_t>(Query, *nearby_it) < ComparableEps) OpFunc(*nearby_it);
+            }else{
+                break;
+            }
+        }
+
+    }else if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseWithin){
+        //This box is aligned with the cartesian grid and bounds the hyper-sphere of radius Eps. The query is strict
+        // (i.e., datum on the box boundary are excluded), so for integer coordinates the half-edge is rounded up.
+        typedef boost::geometry::model::point< S,
+                                               ClusteringDatum_t::SpatialDimensionCount_,
+                                               boost::geometry::cs::cartesian > Corner_t;
+        const S HalfEdge = std::is_integral<S>::value ? static_cast<S>(std::ceil(Eps)) : static_cast<S>(Eps);
+        Corner_t Min, Max;
+        boost::geometry::convert(Query, Min); //Copies only the spatial coordinates.
+        boost::geometry::convert(Query, Max);
+        boost::geometry::subtract_value(Min, HalfEdge);
+        boost::geometry::add_value(Max, HalfEdge);
+        const boost::geometry::model::box<Corner_t> BBox(Min, Max);
+
+        //The filter is stateful, so it must outlive the (copied) output iterator.
+        MetricCandidateFilter<DistanceMetric_t, ClusteringDatum_t, DatumOperation_t> Filter(Query, Eps, OpFunc);
+        auto Sink = [&Filter,&CandidateOp](const ClusteringDatum_t &nearby) -> void {
+            CandidateOp();
+            Filter(nearby);
+            return;
+        };
+        RTree.query( boost::geometry::index::within( BBox ), boost::make_function_output_iterator(Sink) );
+        Filter.Flush();
+
+    }else if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseRadius){
+        VisitDatumWithinRadius<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Query, Eps,
+            [&OpFunc](const ClusteringDatum_t &nearby) -> bool {
+                OpFunc(nearby);
+                return true;
+            }, CandidateOp);
+
+    }else{
+        throw std::runtime_error("Specified spatial query technique has not been implemented.");
+    }
+    return;
+}
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename DatumOperation_t >
+void OnEachDatumWithinEps( const RTree_t & RTree,
+                           const ClusteringDatum_t & Query,
+                           typename ClusteringDatum_t::DistanceType_ Eps,
+                           SpatialQueryTechnique UsersSpatialQueryTechnique,
+                           DatumOperation_t OpFunc ){
+    OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Query, Eps, UsersSpatialQueryTechnique,
+                                                                        OpFunc, [](void) -> void { });
+    return;
+}
+
+
+//This helper function appends the address of each datum within distance Eps of the query datum (including the
+// query datum itself, if present in the tree) to a caller-provided buffer. The buffer is not cleared, so it can be
+// reused across queries to avoid repeated heap allocations.
+//
+// NOTE: The UseWithin and UseRadius techniques perform no heap allocations aside from growing the buffer. The
+//       UseNearby technique relies on Boost.Geometry's incremental nearest-neighbour iterator, which allocates
+//       internally.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename Allocator_t = std::allocator<const ClusteringDatum_t *> >
+void GatherDatumWithinEps( const RTree_t & RTree,
+                           const ClusteringDatum_t & Query,
+                           typename ClusteringDatum_t::DistanceType_ Eps,
+                           SpatialQueryTechnique UsersSpatialQueryTechnique,
+                           std::vector<const ClusteringDatum_t *, Allocator_t> & Out ){
+    OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Query, Eps, UsersSpatialQueryTechnique,
+                         [&Out](const ClusteringDatum_t &nearby) -> void {
+                             Out.push_back( std::addressof(nearby) );
+                         });
+    return;
+}
+
+
+//This routine is the cluster expansion loop shared by DBSCAN() and its variants. It performs the DBSCAN
+// algorithm, but leaves the storage of ClusterIDs up to the caller: the LabelOf functor must map a datum stored in
+// the R*-tree to a (mutable) reference to its ClusterID, wherever that happens to live.
+//
+// Functors should be of the sort:
+//     std::function<ClusterID<...> & (const ClusteringDatum_t &)>;
+//
+// All ClusterIDs must be Unclassified on entry. The R*-tree itself is only read.
+//
+// Instrumentation is only compiled in when Instrumented is true, in which case Stats must be non-null. Use
+// DBSCANExpandClusters() below, which selects the appropriate variant.
+//
+// If Options are provided, the cancellation token is checked and progress is reported periodically from both the
+// outer loop and the cluster expansion loop, so even a single huge cluster can be interrupted.
+//
+template < bool Instrumented,
+           typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t,
+           typename LabelAccessor_t >
+void DBSCANExpandClustersEngine( const RTree_t & RTree,
+                                 typename ClusteringDatum_t::DistanceType_ Eps,
+                                 size_t MinPts,
+                                 SpatialQueryTechnique UsersSpatialQueryTechnique,
+                                 LabelAccessor_t LabelOf,
+                                 ClusteringStats *Stats,
+                                 const DBSCANOptions *Options ){
+
+    typedef typename std::decay<decltype(LabelOf(std::declval<const ClusteringDatum_t &>()))>::type ClusterID_t;
+
+    //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
+    constexpr auto RTreeSpatialQueryGetAll = [](const ClusteringDatum_t &) -> bool { return true; };
+
+    const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
+                                            " This point is missing, indicating numerical stability issues"
+                                            " or logical errors in the spatial indexing approach.";
+
+    auto WorkingCID = ClusterID_t().NextValidClusterID();
+
+    //Progress is measured by the number of datum that have left the Unclassified state.
+    ClusteringProgressMonitor Monitor(Options, RTree.size());
+    Monitor.ThrowIfCancelled();
+    size_t Classified = 0;
+    size_t ClustersFound = 0;
+
+    //Scratch buffers. They are reused for every query and every cluster, so once they have grown to accommodate
+    // the largest neighbourhood (and largest cluster) no further heap allocations are needed.
+    //
+    // The seed queue is a flat FIFO: datum in [SeedsHead, Seeds.size()) are pending expansion. Each datum can
+    // only be queued once (it is queued when it transitions from Unclassified), so the queue is bounded by the
+    // size of the largest cluster.
+    //
+    // The buffers are drawn from the R*-tree's allocator, so they come from the same arena as the tree's nodes when
+    // a ClusteringArenaAllocator is in use.
+    typedef typename std::allocator_traits<typename RTree_t::allocator_type>
+                        ::template rebind_alloc<const ClusteringDatum_t *> ScratchAllocator_t;
+    const ScratchAllocator_t ScratchAllocator(RTree.get_allocator());
+    std::vector<const ClusteringDatum_t *, ScratchAllocator_t> Seeds(ScratchAllocator);
+    std::vector<const ClusteringDatum_t *, ScratchAllocator_t> Results(ScratchAllocator);
+    Seeds.reserve(std::max<size_t>(MinPts * 16, 1024));
+    Results.reserve(std::max<size_t>(MinPts * 16, 1024));
+
+    //Query for nearby items within a distance Eps from the given point. The instrumented variant also counts
+    // the candidates returned by the spatial index.
+    ClusteringStats Local;
+    auto Gather = [&](const ClusteringDatum_t &Q) -> void {
+        Results.clear();
+        if constexpr (Instrumented){
+            OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Q, Eps,
+                UsersSpatialQueryTechnique,
+                [&](const ClusteringDatum_t &nearby) -> void { Results.push_back( std::addressof(nearby) ); },
+                [&](void) -> void { ++Local.CandidatesReturned; });
+            Local.RangeQueries += 1;
+            Local.CandidatesAccepted += Results.size();
+            if(MinPts <= Results.size()) Local.CoreCount += 1;
+        }else{
+            GatherDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Q, Eps,
+                                                                                UsersSpatialQueryTechnique, Results);
+        }
+        return;
+    };
+
+    //When a space-filling curve order is requested, the outer loop visits datum along the curve, so consecutive
+    // range queries probe nearby parts of the R*-tree.
+    //
+    // NOTE: Seeds are not reordered. They are queued in the order the R*-tree returns them, which is already local,
+    //       and sorting each batch of seeds along the curve was found to cost more than it saves.
+    constexpr size_t D = ClusteringDatum_t::SpatialDimensionCount_;
+    std::vector<const ClusteringDatum_t *> CurveOrder;
+    if( (Options != nullptr)
+    &&  (Options->TraversalOrder != ClusteringTraversalOrder::RTree) ){
+        std::array<double, D> Lower;
+        std::array<double, D> Upper;
+        Lower.fill( std::numeric_limits<double>::infinity() );
+        Upper.fill( -std::numeric_limits<double>::infinity() );
+
+        CurveOrder.reserve(RTree.size());
+        auto it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
+        for( ; it != RTree.qend(); ++it){
+            CurveOrder.push_back( std::addressof(*it) );
+            for(size_t d = 0; d < D; ++d){
+                Lower[d] = std::min(Lower[d], static_cast<double>(it->Coordinates[d]));
+                Upper[d] = std::max(Upper[d], static_cast<double>(it->Coordinates[d]));
+            }
+        }
+        SortAlongSpaceFillingCurve<D>(CurveOrder, SpaceFillingCurveKeyer<D>(Options->TraversalOrder, Lower, Upper),
+                                      Options->TraversalThreadCount);
+    }
+
+    //Each datum not yet classified seeds a new cluster (or is marked as noise).
+    auto ExpandFrom = [&](const ClusteringDatum_t &P) -> void {
+        Monitor.Checkpoint(Classified, Classified, ClustersFound);
+        if(!LabelOf(P).IsUnclassified()) return;
+
+        //Query for nearby items ("seeds") within a distance Eps from the current point "P".
+        Gather(P);
+
+        //Check if the point was sufficiently well-connected. 
+        if(Results.size() < MinPts){
+            LabelOf(P).Raw = ClusterID_t::Noise;
+            ++Classified;
+            return;
+        }
+
+        //All datum in `Results` are "density-reachable" from current point "P". So we update their ClusterID
+        // and queue all but the self point for expansion.
+        //
+        // Note: the self point is identified by address, since the distance between distinct datum can be zero.
+        // It should only ever be missing if Boost::Geometry fails to find nearby points properly!
+        Seeds.clear();
+        bool FoundSelfPoint = false;
+        for(const auto *r : Results){
+            auto &CID = LabelOf(*r);
+            if(CID.IsUnclassified()) ++Classified;
+            CID = WorkingCID;
+            if(r == std::addressof(P)){
+                FoundSelfPoint = true;
+            }else{
+                Seeds.push_back(r);
+            }
+        }
+        if(!FoundSelfPoint) throw std::runtime_error(ThrowSelfPointCheck);
+
+        //Loop over the `seeds`, changing cluster IDs as needed.
+        for(size_t SeedsHead = 0; SeedsHead < Seeds.size(); ++SeedsHead){
+            const ClusteringDatum_t &Q = *(Seeds[SeedsHead]);
+            Monitor.Checkpoint(Classified, Classified, ClustersFound);
+
+            //Query for nearby items within a distance Eps from the current point "Q".
+            Gather(Q);
+
+            //Only need to change anything if there are enough neighbouring points.
+            if(Results.size() >= MinPts){
+                for(const auto *r : Results){
+                    auto &CID = LabelOf(*r);
+                    if(CID.IsUnclassified() || CID.IsNoise()){  // equiv. to !CID.IsRegular()
+                        if(CID.IsUnclassified()){
+                            Seeds.push_back(r);
+                            ++Classified;
+                        }
+                        CID = WorkingCID;
+                    }
+                }
+            }
+        }
+        WorkingCID = WorkingCID.NextValidClusterID();
+        ++ClustersFound;
+
+        if constexpr (Instrumented){
+            //Every datum is queued at most once per cluster, so the queue's final size is its longest length.
+            Local.MaxSeedQueueLength = std::max<uint64_t>(Local.MaxSeedQueueLength, Seeds.size());
+            Local.ClusterCount += 1;
+        }
+    };
+
+    if(CurveOrder.empty()){
+        typename RTree_t::const_query_iterator outer_it;
+        outer_it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
+        for( ; outer_it != RTree.qend(); ++outer_it) ExpandFrom(*outer_it);
+    }else{
+        for(const auto *P : CurveOrder) ExpandFrom(*P);
+    }
+
+    if constexpr (Instrumented){
+        //Datum are only queried a second time if they were not core datum the first time, so core datum are counted
+        // exactly once. Noise is only final once all clusters have been expanded.
+        uint64_t Total = 0;
+        auto outer_it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
+        for( ; outer_it != RTree.qend(); ++outer_it){
+            Total += 1;
+            if(LabelOf(*outer_it).IsNoise()) Local.NoiseCount += 1;
+        }
+        Local.BorderCount = Total - Local.CoreCount - Local.NoiseCount;
+        Stats->MergeCounters(Local);
+    }
+    Monitor.Finish(Classified, ClustersFound);
+    return;
+}
+
 template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
-           typename ClusteringDatum_t >
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t,
+           typename LabelAccessor_t >
+void DBSCANExpandClusters( const RTree_t & RTree,
+                           typename ClusteringDatum_t::DistanceType_ Eps,
+                           size_t MinPts,
+                           SpatialQueryTechnique UsersSpatialQueryTechnique,
+                           LabelAccessor_t LabelOf,
+                           ClusteringStats *Stats = nullptr,
+                           const DBSCANOptions *Options = nullptr ){
+    ClusteringStatsPhaseTimer Timer(Stats, "expand clusters");
+    if(Stats == nullptr){
+        DBSCANExpandClustersEngine<false, RTree_t, ClusteringDatum_t, DistanceMetric_t>(
+            RTree, Eps, MinPts, UsersSpatialQueryTechnique, LabelOf, Stats, Options);
+    }else{
+        DBSCANExpandClustersEngine<true, RTree_t, ClusteringDatum_t, DistanceMetric_t>(
+            RTree, Eps, MinPts, UsersSpatialQueryTechnique, LabelOf, Stats, Options);
+    }
+    return;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
 void DBSCAN( RTree_t & RTree,
-             typename ClusteringDatum_t::SpatialType_ Eps,
+             typename ClusteringDatum_t::DistanceType_ Eps,
              size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
-             SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin ){
+             SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+             ClusteringStats *Stats = nullptr,
+             const DBSCANOptions *Options = nullptr ){
 
     // This routine is an implementation of the well-known DBSCAN clustering algorithm which is 
     //   described in the widely-cited 1996 conference proceedings article:
@@ -162,7 +647,24 @@ void DBSCAN( RTree_t & RTree,
     // 3. MinPts --> DBSCAN algorithm parameter. Sets the minimal number of nearby connections each point
     //               must have. Authors recommend 2x the dimension.
     // 4. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
-    //                              Makes a large impact on performance!
+    //                              Makes a large impact on performance! UseGrid is often fastest for dense,
+    //                              low-dimensional data. (It hands the whole run off to DBSCANGrid().)
+    //                              UseRadius prunes R*-tree nodes by their distance to the query datum rather
+    //                              than a bounding box, which helps most in 3D and above. See
+    //                              VisitDatumWithinRadius().
+    //                              1D datum are always clustered by sorting instead of querying the R*-tree
+    //                              unless UseGrid is specified. See DBSCANSortAndSweepLabels().
+    // 5. Stats --> If provided, instrumentation (range queries issued, candidates returned and accepted,
+    //              core/border/noise counts, the longest seed queue, and wall time per phase) is added to it.
+    //              The default (nullptr) selects an uninstrumented code path. See ClusteringStats.
+    // 6. Options --> If provided, a progress callback is invoked periodically and a cancellation token is polled.
+    //                A cancelled run throws ClusteringCancelled and leaves the ClusterIDs in an unspecified state.
+    //                The options can also select a space-filling curve traversal order, which is ignored by the grid
+    //                and 1D techniques; see DBSCANOptions and DBSCANAsync().
+    //
+    // The distance metric is a compile-time policy given by the DistanceMetric_t template parameter. The default,
+    //   EuclideanDistanceMetric, compares squared distances against Eps^2 so no square roots are needed. Manhattan
+    //   and Chebyshev metrics are also provided. See YgorClusteringMetrics.hpp for how to write others.
     //
     // NOTE: This routine ignores any Attributes and UserData in the ClusteringDatum instances. Points are
     //       heavily copied inside the R*-tree during insert and removal, so keep the ClusteringDatum 
@@ -206,11 +708,28 @@ void DBSCAN( RTree_t & RTree,
     //       clusters!
     //
 
+    const bool UseGrid = (UsersSpatialQueryTechnique == SpatialQueryTechnique::UseGrid);
+    if(UseGrid || (ClusteringDatum_t::SpatialDimensionCount_ == 1)){
+        //These techniques are fast enough that cancellation is only checked up-front. Stats are needed to report
+        // the number of clusters found.
+        ClusteringProgressMonitor Monitor(Options, RTree.size());
+        Monitor.ThrowIfCancelled();
+        ClusteringStats FallbackStats;
+        ClusteringStats *RunStats = ((Stats == nullptr) && Monitor.IsActive()) ? &FallbackStats : Stats;
+        const uint64_t ClustersBefore = (RunStats == nullptr) ? 0 : RunStats->ClusterCount;
+
+        if(UseGrid){
+            DBSCANGrid<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Eps, MinPts, 1, RunStats);
+        }else if constexpr(ClusteringDatum_t::SpatialDimensionCount_ == 1){
+            DBSCANSortAndSweep<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Eps, MinPts, 1, RunStats);
+        }
+        Monitor.Finish(RTree.size(), (RunStats == nullptr) ? 0 : (RunStats->ClusterCount - ClustersBefore));
+        return;
+    }
+
     //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
     constexpr auto RTreeSpatialQueryGetAll = [](const ClusteringDatum_t &) -> bool { return true; };
 
-    typedef boost::geometry::model::box<ClusteringDatum_t> Box_t;
-
 
     //Ensure all datum start with Unclassified ClusterIDs. It is necessary to have this here, for example, 
     // if the user has re-run the algorithm or tampered with the IDs.
@@ -218,6 +737,7 @@ void DBSCAN( RTree_t & RTree,
     // NOTE: pre-defining some objects to be in specific clusters is not supported. You can accomplish this
     // by attaching UserData to 'tag' these objects.
     {
+        ClusteringStatsPhaseTimer Timer(Stats, "reset labels");
         typename RTree_t::const_query_iterator it;
         it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
         for( ; it != RTree.qend(); ++it){
@@ -225,132 +745,146 @@ void DBSCAN( RTree_t & RTree,
         }
     }
 
+    //Main loop. ClusterIDs are stored directly in the datum held by the R*-tree.
+    DBSCANExpandClusters<RTree_t, ClusteringDatum_t, DistanceMetric_t>(
+        RTree, Eps, MinPts, UsersSpatialQueryTechnique,
+        [](const ClusteringDatum_t &d) -> ClusterID<typename ClusteringDatum_t::ClusterIDType_> & {
+            return const_cast<ClusteringDatum_t &>(d).CID;
+        }, Stats, Options);
+    return;
+}
 
-    //Main loop.
-    {
-        const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
-                                                " This point is missing, indicating numerical stability issues"
-                                                " or logical errors in the spatial indexing approach.";
-        const std::string ThrowNotImplemented = "Specified spatial query technique has not been implemented.";
-                                  
-        auto WorkingCID = ClusterID<typename ClusteringDatum_t::ClusterIDType_>().NextValidClusterID();
 
-        typename RTree_t::const_query_iterator outer_it;
-        outer_it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
-        for( ; outer_it != RTree.qend(); ++outer_it){
-            if(!outer_it->CID.IsUnclassified()) continue;
-
-            //Query for nearby items ("seeds") within a distance Eps from the current point "*outer_it".
-            std::list<typename RTree_t::const_query_iterator> seed_its;
-            if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseNearby){
-                typename RTree_t::const_query_iterator nearby_it;
-                nearby_it = RTree.qbegin( boost::geometry::index::nearest( *outer_it, RTree.size() ) );
-                if(nearby_it == RTree.qend()) throw std::runtime_error(ThrowSelfPointCheck);
-                for( ; nearby_it != RTree.qend(); ++nearby_it){
-                    if(boost::geometry::distance(*outer_it, *nearby_it) < Eps){
-                        seed_its.push_back( nearby_it );
-                    }else{
-                        break;
-                    }
-                }
-            }else if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseWithin){
-                //This box is aligned with the cartesian grid and bounds the hyper-sphere of radius Eps.
-                Box_t BBox( outer_it->CoordinateAlignedBBoxMinimal(Eps),
-                            outer_it->CoordinateAlignedBBoxMaximal(Eps) );
-
-                typename RTree_t::const_query_iterator nearby_it;
-                nearby_it = RTree.qbegin( boost::geometry::index::within( BBox ) );
-                if(nearby_it == RTree.qend()) throw std::runtime_error(ThrowSelfPointCheck);
-                for( ; nearby_it != RTree.qend(); ++nearby_it){
-                    if(boost::geometry::distance(*outer_it, *nearby_it) < Eps){
-                        seed_its.push_back( nearby_it );
-                    }
-                }
-            }else{
-                throw std::runtime_error(ThrowNotImplemented);
-            }
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void DBSCAN( const RTree_t & RTree,
+             std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > & Labels,
+             typename ClusteringDatum_t::DistanceType_ Eps,
+             size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+             SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+             ClusteringStats *Stats = nullptr,
+             const DBSCANOptions *Options = nullptr ){
 
-            //Check if the point was sufficiently well-connected. 
-            if(seed_its.size() < MinPts){
-                const_cast<ClusteringDatum_t &>(*outer_it).CID.Raw = ClusterID<typename ClusteringDatum_t::ClusterIDType_>::Noise;
-                continue;
-            }else{ 
-                //All datum in `seeds` are "density-reachable" from current point "*outer_it".
-                // So we update their ClusterID.
-                for(auto seed_it : seed_its) const_cast<ClusteringDatum_t &>(*seed_it).CID = WorkingCID;
-
-                //Remove the self point from the nearby points query.
-                // Note: boost::geometry::index::nearest() will return the nearest first. Since the
-                // distance between any point and itself should always be zero, the first point will
-                // be the self point. So we compare the addresses to be certain. The following
-                // should only ever fail if Boost::Geometry fails to find nearby points properly!
-                {
-                    auto IsTheSelfPoint = [outer_it](const typename RTree_t::const_query_iterator &in_it) -> bool {
-                        return (std::addressof(*in_it) == std::addressof(*outer_it));
-                    };
-                    //auto SelfPoint_it = std::find_if(seed_its.begin(), seed_its.end()
-                    const auto SizePriorToSelfPointRemoval = seed_its.size();
-                    seed_its.remove_if(IsTheSelfPoint);
-                    const auto SizeAfterSelfPointRemoval = seed_its.size();
-                    if((SizeAfterSelfPointRemoval + 1) != SizePriorToSelfPointRemoval){
-                        throw std::runtime_error(ThrowSelfPointCheck);
-                    }
-                }
+    // This overload performs DBSCAN without modifying the R*-tree. ClusterIDs are written to the caller-provided
+    //   Labels vector instead of the datum, one per datum in R*-tree traversal order (i.e., the order used by
+    //   OnEachDatum() and RTreeDatumIndex). The CID members of the datum are ignored.
+    //
+    // Since the R*-tree is only read, a single tree can be shared by any number of concurrent runs (e.g., with
+    //   different Eps and MinPts), each writing to its own Labels vector.
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will not be modified.
+    // 2. Labels --> Resized to the number of datum in the R*-tree and overwritten with the results.
+    // 3. Eps --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 5. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+    // 6. Stats --> If provided, instrumentation is recorded. See DBSCAN().
+    // 7. Options --> If provided, progress is reported and cancellation is honoured. See DBSCAN().
+    //
+    // NOTE: The clustering is identical to what the in-place DBSCAN() would produce.
+    //
+    // NOTE: Labels are located via the datum addresses, which requires a sorted address table and a binary search
+    //       per label update. This is a modest overhead compared with the spatial queries.
+    //
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+
+    ClusteringStatsPhaseTimer IndexTimer(Stats, "index datum");
+    const RTreeDatumIndex<RTree_t, ClusteringDatum_t> Index(RTree);
+    Labels.assign(Index.size(), ClusterID_t(ClusterID_t::Unclassified));
+    IndexTimer.Stop();
+
+    const bool UseGrid = (UsersSpatialQueryTechnique == SpatialQueryTechnique::UseGrid);
+    if(UseGrid || (ClusteringDatum_t::SpatialDimensionCount_ == 1)){
+        ClusteringProgressMonitor Monitor(Options, Index.size());
+        Monitor.ThrowIfCancelled();
+        ClusteringStats FallbackStats;
+        ClusteringStats *RunStats = ((Stats == nullptr) && Monitor.IsActive()) ? &FallbackStats : Stats;
+        const uint64_t ClustersBefore = (RunStats == nullptr) ? 0 : RunStats->ClusterCount;
+
+        if(UseGrid){
+            Labels = DBSCANGridLabels<ClusteringDatum_t, DistanceMetric_t>(Index.Datum, Eps, MinPts, 1, RunStats);
+        }else if constexpr(ClusteringDatum_t::SpatialDimensionCount_ == 1){
+            Labels = DBSCANSortAndSweepLabels<ClusteringDatum_t, DistanceMetric_t>(Index.Datum, Eps, MinPts, 1, RunStats);
+        }
+        Monitor.Finish(Index.size(), (RunStats == nullptr) ? 0 : (RunStats->ClusterCount - ClustersBefore));
+        return;
+    }
 
-                //Loop over the `seeds`, changing cluster IDs as needed.
-                while(!seed_its.empty()){
-                    auto currentP_it = seed_its.front();
-
-                    //Query for nearby items within a distance Eps from the current point "*currentP_it".
-                    std::list<typename RTree_t::const_query_iterator> result_its;
-                    if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseNearby){
-                        typename RTree_t::const_query_iterator nearby_it;
-                        nearby_it = RTree.qbegin( boost::geometry::index::nearest( *currentP_it, RTree.size() ) );
-                        if(nearby_it == RTree.qend()) throw std::runtime_error(ThrowSelfPointCheck);
-                        for( ; nearby_it != RTree.qend(); ++nearby_it){
-                            if(boost::geometry::distance(*currentP_it, *nearby_it) < Eps){
-                                result_its.push_back( nearby_it );
-                            }else{
-                                break;
-                            }
-                        }
-                    }else if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseWithin){
-                        //This box is aligned with the cartesian grid and bounds the hyper-sphere of radius Eps.
-                        Box_t BBox( currentP_it->CoordinateAlignedBBoxMinimal(Eps),
-                                    currentP_it->CoordinateAlignedBBoxMaximal(Eps) );
-                
-                        typename RTree_t::const_query_iterator nearby_it;
-                        nearby_it = RTree.qbegin( boost::geometry::index::within( BBox ) );
-                        if(nearby_it == RTree.qend()) throw std::runtime_error(ThrowSelfPointCheck);
-                        for( ; nearby_it != RTree.qend(); ++nearby_it){
-                            if(boost::geometry::distance(*currentP_it, *nearby_it) < Eps){
-                                result_its.push_back( nearby_it );
-                            }
-                        }
+    DBSCANExpandClusters<RTree_t, ClusteringDatum_t, DistanceMetric_t>(
+        RTree, Eps, MinPts, UsersSpatialQueryTechnique,
+        [&](const ClusteringDatum_t &d) -> ClusterID_t & {
+            return Labels[Index.IndexOf(d)];
+        }, Stats, Options);
+    return;
+}
 
-                    }else{
-                        throw std::runtime_error(ThrowNotImplemented);
-                    }
 
-                    //Only need to change anything if there are enough neighbouring points.
-                    if(result_its.size() >= MinPts){
-                        for(auto result_it : result_its){
-                            if(result_it->CID.IsUnclassified() || result_it->CID.IsNoise()){  // equiv. to !result_it->CID.IsRegular()
-                                if(result_it->CID.IsUnclassified()){
-                                    seed_its.push_back(result_it);
-                                }
-                                const_cast<ClusteringDatum_t &>(*result_it).CID = WorkingCID;
-                            }
-                        }
-                    }
-                 
-                    seed_its.pop_front();
-                }
+template < typename RTree_t,  //A Boost.Geometry R*-tree of ClusteringStore_t::Point_t, specifically.
+           typename ClusteringStore_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void DBSCANIndexed( const RTree_t & RTree,
+                    ClusteringStore_t & Store,
+                    typename ClusteringStore_t::DistanceType_ Eps,
+                    size_t MinPts = ClusteringStore_t::SpatialDimensionCount_ * 2,
+                    SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin ){
+
+    // This routine performs DBSCAN on datum held in a ClusteringStore (see YgorClusteringIndexed.hpp). The R*-tree
+    //   holds only IndexedClusteringPoints, i.e., coordinates and an index into the store, and is not modified.
+    //   Results are written into Store.CIDs.
+    //
+    // This is useful when the datum carry large or expensive-to-copy user data, since the R*-tree never holds
+    //   (or copies) it. Tree nodes also stay compact, which improves cache behaviour during queries.
+    //
+    // User parameters:
+    //
+    // 1. RTree --> An R*-tree holding one point for every datum in the store. See BuildIndexedRTree().
+    // 2. Store --> The datum being clustered. Only the CIDs are modified.
+    // 3. Eps --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 5. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+    //
+    // NOTE: The clustering is identical to what DBSCAN() produces for the same datum and R*-tree layout.
+    //
+    // NOTE: Store datum which are not present in the R*-tree are left Unclassified.
+    //
+    typedef typename RTree_t::value_type Point_t;
+    typedef ClusterID<typename ClusteringStore_t::ClusterIDType_> ClusterID_t;
+
+    //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
+    constexpr auto RTreeSpatialQueryGetAll = [](const Point_t &) -> bool { return true; };
+
+    std::vector<const Point_t *> Points;
+    Points.reserve(RTree.size());
+    {
+        typename RTree_t::const_query_iterator it;
+        it = RTree.qbegin(boost::geometry::index::satisfies( RTreeSpatialQueryGetAll ));
+        for( ; it != RTree.qend(); ++it){
+            if(Store.size() <= static_cast<size_t>(it->Index)){
+                throw std::runtime_error("R*-tree refers to a datum that is not present in the store.");
             }
-            WorkingCID = WorkingCID.NextValidClusterID();
+            Points.push_back( std::addressof(*it) );
         }
+    }
+    Store.CIDs.assign(Store.size(), ClusterID_t(ClusterID_t::Unclassified));
 
+    if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseGrid){
+        const auto Labels = DBSCANGridLabels<Point_t, DistanceMetric_t>(Points, Eps, MinPts);
+        for(size_t i = 0; i < Points.size(); ++i) Store.CIDs[Points[i]->Index] = Labels[i];
+        return;
     }
+    if constexpr(Point_t::SpatialDimensionCount_ == 1){
+        const auto Labels = DBSCANSortAndSweepLabels<Point_t, DistanceMetric_t>(Points, Eps, MinPts);
+        for(size_t i = 0; i < Points.size(); ++i) Store.CIDs[Points[i]->Index] = Labels[i];
+        return;
+    }
+
+    DBSCANExpandClusters<RTree_t, Point_t, DistanceMetric_t>(
+        RTree, Eps, MinPts, UsersSpatialQueryTechnique,
+        [&Store](const Point_t &P) -> ClusterID_t & {
+            return Store.CIDs[P.Index];
+        });
     return;
 }
 
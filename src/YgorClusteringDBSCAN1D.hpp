@@ -0,0 +1,234 @@
+
+#ifndef YGOR_CLUSTERING_DBSCAN1D_HPP
+#define YGOR_CLUSTERING_DBSCAN1D_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <memory>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringStats.hpp"
+
+
+//This routine is an exact sort-and-sweep implementation of DBSCAN for one-dimensional datum. It operates on a list of
+// datum and returns one ClusterID per datum, in the same order, just like DBSCANGridLabels().
+//
+// In 1D every Eps-neighbourhood is a contiguous run of the sorted datum, so:
+//   - neighbourhood sizes are found with a two-pointer sweep over the sorted coordinates,
+//   - two core datum are density-connected iff every gap between consecutive core datum separating them is
+//     shorter than Eps, so clusters are maximal runs of sorted core datum, and
+//   - a border datum can only be reached from the nearest core datum on either side.
+// After an O(N log N) sort, everything else is linear and no spatial index queries are needed.
+//
+// Clusters are numbered in order of the first core datum in the input list belonging to each cluster, and border
+// datum are attached to the lowest-numbered reachable cluster, so the result is identical to DBSCANGridLabels().
+//
+// If Stats is provided, phase timings and core/border/noise counts are recorded. No range queries are issued.
+//
+template < typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> >
+    DBSCANSortAndSweepLabels( const std::vector<const ClusteringDatum_t *> & Datum,
+                              typename ClusteringDatum_t::DistanceType_ Eps,
+                              size_t MinPts,
+                              size_t ThreadCount = 1,
+                              ClusteringStats *Stats = nullptr ){
+
+    typedef typename ClusteringDatum_t::SpatialType_ T;
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+
+    static_assert(ClusteringDatum_t::SpatialDimensionCount_ == 1, "Sort-and-sweep clustering requires 1D datum.");
+    if(!(0 < Eps)) throw std::runtime_error("Parameter 'Eps' must be positive for sort-and-sweep clustering.");
+
+    const size_t N = Datum.size();
+    std::vector<ClusterID_t> Labels(N, ClusterID_t(ClusterID_t::Noise));
+    if(N == 0) return Labels;
+
+    typedef typename ClusteringDatum_t::DistanceType_ DistT;
+    const auto ComparableEps = DistanceMetric_t::ToComparable(Eps);
+    auto IsNeighbour = [ComparableEps](T A, T B) -> bool {
+        return (DistanceMetric_t::Accumulate(static_cast<DistT>(0), static_cast<DistT>(A) - static_cast<DistT>(B))
+                < ComparableEps);
+    };
+
+    ClusteringStatsPhaseTimer SortTimer(Stats, "sort");
+
+    //Sort (coordinate, index) pairs. Keeping the coordinates alongside the indices keeps the sweeps cache-friendly.
+    std::vector<std::pair<T, size_t>> Sorted(N);
+    for(size_t i = 0; i < N; ++i){
+        const T x = Datum[i]->Coordinates[0];
+        if(!std::isfinite(static_cast<double>(x))){
+            throw std::runtime_error("Encountered non-finite coordinates. Cannot sort datum.");
+        }
+        Sorted[i] = std::make_pair(x, i);
+    }
+    ParallelSort(Sorted.begin(), Sorted.end(), std::less<std::pair<T, size_t>>(), ThreadCount);
+
+    SortTimer.Stop();
+
+    //Identify core datum with a two-pointer sweep. Sorted chunks are swept independently; each chunk locates its
+    // initial window with a binary search.
+    constexpr size_t ChunkSize = 16384;
+    const size_t ChunkCount = (N + ChunkSize - 1) / ChunkSize;
+    ClusteringStatsPhaseTimer CoreTimer(Stats, "identify core datum");
+    std::vector<uint8_t> IsCore(N, 0); //Indexed by sorted position.
+    ParallelForEachIndex(ChunkCount, ThreadCount, [&](size_t c) -> void {
+        const size_t Begin = c * ChunkSize;
+        const size_t End = std::min(N, Begin + ChunkSize);
+        const T x0 = Sorted[Begin].first;
+        size_t Lo = static_cast<size_t>(std::distance(Sorted.begin(),
+                        std::partition_point(Sorted.begin(), Sorted.begin() + Begin,
+                            [&](const std::pair<T, size_t> &q) -> bool { return !IsNeighbour(q.first, x0); })));
+        size_t Hi = Begin;
+        for(size_t p = Begin; p < End; ++p){
+            const T x = Sorted[p].first;
+            while(!IsNeighbour(Sorted[Lo].first, x)) ++Lo;
+            if(Hi < p) Hi = p;
+            while((Hi < N) && IsNeighbour(Sorted[Hi].first, x)) ++Hi;
+            IsCore[p] = (MinPts <= (Hi - Lo)) ? 1 : 0;
+        }
+    }, 1);
+
+    CoreTimer.Stop();
+
+    //Group consecutive core datum into runs (i.e., clusters). Each run is numbered by its first core datum in the
+    // input order.
+    ClusteringStatsPhaseTimer FormTimer(Stats, "form clusters");
+    const size_t NoRun = std::numeric_limits<size_t>::max();
+    std::vector<size_t> RunOf(N, NoRun);        //Indexed by sorted position.
+    std::vector<size_t> RunFirstDatum;
+    {
+        size_t PrevCore = NoRun;
+        for(size_t p = 0; p < N; ++p){
+            if(!IsCore[p]) continue;
+            if((PrevCore == NoRun) || !IsNeighbour(Sorted[PrevCore].first, Sorted[p].first)){
+                RunFirstDatum.push_back(Sorted[p].second);
+            }
+            RunOf[p] = RunFirstDatum.size() - 1;
+            RunFirstDatum.back() = std::min(RunFirstDatum.back(), Sorted[p].second);
+            PrevCore = p;
+        }
+    }
+    std::vector<ClusterID_t> RunLabels(RunFirstDatum.size());
+    {
+        std::vector<size_t> RunOrder(RunFirstDatum.size());
+        for(size_t r = 0; r < RunOrder.size(); ++r) RunOrder[r] = r;
+        std::sort(RunOrder.begin(), RunOrder.end(), [&](size_t A, size_t B) -> bool {
+            return (RunFirstDatum[A] < RunFirstDatum[B]);
+        });
+        auto WorkingCID = ClusterID_t().NextValidClusterID();
+        for(size_t k = 0; k < RunOrder.size(); ++k){
+            if(k != 0) WorkingCID = WorkingCID.NextValidClusterID();
+            RunLabels[RunOrder[k]] = WorkingCID;
+        }
+    }
+
+    //Label core datum, then attach each border datum to the lowest-numbered cluster among the nearest core datum on
+    // either side.
+    size_t PrevCore = NoRun;
+    for(size_t p = 0; p < N; ++p){
+        if(IsCore[p]){
+            Labels[Sorted[p].second] = RunLabels[RunOf[p]];
+            PrevCore = p;
+        }else if((PrevCore != NoRun) && IsNeighbour(Sorted[PrevCore].first, Sorted[p].first)){
+            Labels[Sorted[p].second] = RunLabels[RunOf[PrevCore]];
+        }
+    }
+    size_t NextCore = NoRun;
+    for(size_t p = N; p-- > 0; ){
+        if(IsCore[p]){
+            NextCore = p;
+            continue;
+        }
+        if((NextCore == NoRun) || !IsNeighbour(Sorted[NextCore].first, Sorted[p].first)) continue;
+        auto &L = Labels[Sorted[p].second];
+        const auto &Candidate = RunLabels[RunOf[NextCore]];
+        if(!L.IsRegular() || (Candidate < L)) L = Candidate;
+    }
+    FormTimer.Stop();
+
+    if(Stats != nullptr){
+        Stats->AddClassification(N, std::count(IsCore.begin(), IsCore.end(), 1),
+                                 std::count_if(Labels.begin(), Labels.end(),
+                                               [](const ClusterID_t &L) -> bool { return L.IsNoise(); }),
+                                 RunLabels.size());
+    }
+    return Labels;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void DBSCANSortAndSweep( RTree_t & RTree,
+                         typename ClusteringDatum_t::DistanceType_ Eps,
+                         size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                         size_t ThreadCount = 1,
+                         ClusteringStats *Stats = nullptr ){
+
+    // This routine is an exact implementation of DBSCAN for 1D datum. It accepts the same parameters and produces
+    //   the same clustering as DBSCANGrid(), but works by sorting the datum once and sweeping over them rather than
+    //   performing spatial queries. It is selected at compile-time by DBSCAN(), DBSCANParallel(), and
+    //   DBSCANIndexed() whenever the datum are 1D (unless UseGrid is requested), but can also be called directly.
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will be modified in-place. The tree
+    //              is only used to enumerate the datum and to hold the resulting ClusterIDs.
+    // 2. Eps --> DBSCAN algorithm parameter. See DBSCAN(). Must be positive.
+    // 3. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. ThreadCount --> The number of threads to use, including the calling thread. The sort and the core datum
+    //                    sweep are parallelized; cluster formation is a single linear pass.
+    // 5. Stats --> If provided, instrumentation is recorded. See ClusteringStats.
+    //
+    // NOTE: Core and noise labels are identical to DBSCAN(). Border datum reachable from two clusters are assigned
+    //       to the lower-numbered cluster. See the note in DBSCANParallel().
+    //
+    // NOTE: Memory usage is a few machine words per datum.
+    //
+    std::vector<const ClusteringDatum_t *> Datum;
+    Datum.reserve(RTree.size());
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&Datum](const typename RTree_t::const_query_iterator &it) -> void {
+        Datum.push_back( std::addressof(*it) );
+    });
+
+    const auto Labels = DBSCANSortAndSweepLabels<ClusteringDatum_t, DistanceMetric_t>(Datum, Eps, MinPts, ThreadCount, Stats);
+    for(size_t i = 0; i < Datum.size(); ++i){
+        const_cast<ClusteringDatum_t &>(*(Datum[i])).CID = Labels[i];
+    }
+    return;
+}
+
+#endif //YGOR_CLUSTERING_DBSCAN1D_HPP
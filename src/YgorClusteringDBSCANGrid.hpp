@@ -0,0 +1,350 @@
+
+#ifndef YGOR_CLUSTERING_DBSCANGRID_HPP
+#define YGOR_CLUSTERING_DBSCANGRID_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringStats.hpp"
+
+
+//This routine is the core of a grid-based, exact DBSCAN implementation. It operates on a list of datum and returns
+// one ClusterID per datum, in the same order. See DBSCANGrid() below for a description.
+//
+// Clusters are numbered in order of the first core datum in the input list belonging to each cluster, which mimics
+// the order in which DBSCAN() discovers clusters when the input is in R*-tree traversal order.
+//
+// If Stats is provided, phase timings and core/border/noise counts are recorded. No range queries are issued.
+//
+template < typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> >
+    DBSCANGridLabels( const std::vector<const ClusteringDatum_t *> & Datum,
+                      typename ClusteringDatum_t::DistanceType_ Eps,
+                      size_t MinPts,
+                      size_t ThreadCount = 1,
+                      ClusteringStats *Stats = nullptr ){
+
+    constexpr size_t D = ClusteringDatum_t::SpatialDimensionCount_;
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+    typedef std::array<int64_t, D> CellKey_t;
+
+    static_assert(0 < D, "Datum must have at least one spatial dimension.");
+    if(!(0 < Eps)) throw std::runtime_error("Parameter 'Eps' must be positive for grid-based clustering.");
+
+    const size_t N = Datum.size();
+    std::vector<ClusterID_t> Labels(N, ClusterID_t(ClusterID_t::Noise));
+    if(N == 0) return Labels;
+
+    auto Coordinate = [](const ClusteringDatum_t &P, size_t d) -> double {
+        return static_cast<double>(P.Coordinates[d]);
+    };
+    const auto ComparableEps = DistanceMetric_t::ToComparable(Eps);
+    auto IsNeighbour = [ComparableEps](const ClusteringDatum_t &A, const ClusteringDatum_t &B) -> bool {
+        return (MetricComparableDistance<DistanceMetric_t>(A, B) < ComparableEps);
+    };
+
+    //Cells are half-open hyper-cubes with a diameter (in the chosen metric) just shy of Eps, so any two datum
+    // sharing a cell are neighbours. The slight shrinkage guards against round-off when binning datum near cell
+    // boundaries. This is only reliable when coordinates can be resolved to much less than the shrinkage, so
+    // extremely small Eps are rejected.
+    const double CellSide = DistanceMetric_t::template CellSide<D>(static_cast<double>(Eps)) * (1.0 - 1.0E-6);
+
+    std::array<double, D> Origin;
+    {
+        std::array<double, D> Max;
+        Origin.fill( std::numeric_limits<double>::infinity() );
+        Max.fill( -std::numeric_limits<double>::infinity() );
+        for(const auto *P : Datum){
+            for(size_t d = 0; d < D; ++d){
+                Origin[d] = std::min(Origin[d], Coordinate(*P, d));
+                Max[d] = std::max(Max[d], Coordinate(*P, d));
+            }
+        }
+        for(size_t d = 0; d < D; ++d){
+            if(!std::isfinite(Origin[d]) || !std::isfinite(Max[d])){
+                throw std::runtime_error("Encountered non-finite coordinates. Cannot bin datum into a grid.");
+            }
+            const double Magnitude = std::max(std::abs(Origin[d]), std::abs(Max[d]));
+            if(1.0E9 < (Magnitude / CellSide)){
+                throw std::runtime_error("Eps is too small relative to the coordinate magnitudes for grid-based clustering.");
+            }
+        }
+    }
+    auto CellKeyOf = [&](const ClusteringDatum_t &P) -> CellKey_t {
+        CellKey_t Key;
+        for(size_t d = 0; d < D; ++d){
+            Key[d] = static_cast<int64_t>(std::floor((Coordinate(P, d) - Origin[d]) / CellSide));
+        }
+        return Key;
+    };
+
+    //Bin the datum. Cells are stored as contiguous runs within `Order`.
+    ClusteringStatsPhaseTimer BinTimer(Stats, "bin datum");
+    std::vector<CellKey_t> Keys(N);
+    ParallelForEachIndex(N, ThreadCount, [&](size_t i) -> void {
+        Keys[i] = CellKeyOf(*(Datum[i]));
+    });
+
+    std::vector<size_t> Order(N);
+    for(size_t i = 0; i < N; ++i) Order[i] = i;
+    std::sort(Order.begin(), Order.end(), [&](size_t L, size_t R) -> bool {
+        return (Keys[L] < Keys[R]) || ((Keys[L] == Keys[R]) && (L < R));
+    });
+
+    std::vector<CellKey_t> CellKeys;
+    std::vector<size_t> CellBegin; //Cell c spans Order[CellBegin[c]] to Order[CellBegin[c+1] - 1].
+    std::vector<size_t> CellOf(N);
+    for(size_t n = 0; n < N; ++n){
+        const size_t i = Order[n];
+        if(CellKeys.empty() || (CellKeys.back() != Keys[i])){
+            CellKeys.push_back(Keys[i]);
+            CellBegin.push_back(n);
+        }
+        CellOf[i] = CellKeys.size() - 1;
+    }
+    const size_t CellCount = CellKeys.size();
+    CellBegin.push_back(N);
+    Keys.clear();
+    Keys.shrink_to_fit();
+
+    auto FindCell = [&](const CellKey_t &Key) -> size_t {
+        auto it = std::lower_bound(CellKeys.begin(), CellKeys.end(), Key);
+        if((it == CellKeys.end()) || (*it != Key)) return CellCount;
+        return static_cast<size_t>(std::distance(CellKeys.begin(), it));
+    };
+
+    //Enumerate the offsets of all cells that could possibly contain a neighbour, i.e., cells whose nearest
+    // approach to the central cell is closer than Eps. The central cell itself is excluded.
+    std::vector<CellKey_t> Offsets;
+    {
+        const int64_t Reach = static_cast<int64_t>(std::ceil(static_cast<double>(Eps) / CellSide));
+        CellKey_t Offset;
+        Offset.fill(-Reach);
+        for(;;){
+            double Gap = 0.0;
+            bool IsCentral = true;
+            for(size_t d = 0; d < D; ++d){
+                const double Delta = static_cast<double>(std::max<int64_t>(std::abs(Offset[d]) - 1, 0)) * CellSide;
+                Gap = DistanceMetric_t::Accumulate(Gap, Delta);
+                IsCentral = IsCentral && (Offset[d] == 0);
+            }
+            if(!IsCentral && (Gap < DistanceMetric_t::ToComparable(static_cast<double>(Eps)))) Offsets.push_back(Offset);
+
+            size_t d = 0;
+            for( ; d < D; ++d){
+                if(Offset[d] < Reach){
+                    ++Offset[d];
+                    break;
+                }
+                Offset[d] = -Reach;
+            }
+            if(d == D) break;
+        }
+    }
+
+    //Resolve each cell's non-empty neighbouring cells once, up-front.
+    std::vector<size_t> NeighbourBegin(CellCount + 1, 0);
+    std::vector<size_t> Neighbours;
+    {
+        std::vector<std::vector<size_t>> PerCell(CellCount);
+        ParallelForEachIndex(CellCount, ThreadCount, [&](size_t c) -> void {
+            for(const auto &Offset : Offsets){
+                CellKey_t Key = CellKeys[c];
+                for(size_t d = 0; d < D; ++d) Key[d] += Offset[d];
+                const size_t n = FindCell(Key);
+                if(n != CellCount) PerCell[c].push_back(n);
+            }
+        });
+        for(size_t c = 0; c < CellCount; ++c){
+            NeighbourBegin[c + 1] = NeighbourBegin[c] + PerCell[c].size();
+            Neighbours.insert(Neighbours.end(), PerCell[c].begin(), PerCell[c].end());
+        }
+    }
+
+    BinTimer.Stop();
+
+    //Identify core datum. Cells containing at least MinPts datum are entirely core, without any distance checks.
+    ClusteringStatsPhaseTimer CoreTimer(Stats, "identify core datum");
+    std::vector<uint8_t> IsCore(N, 0);
+    std::vector<uint8_t> CellHasCore(CellCount, 0);
+    ParallelForEachIndex(CellCount, ThreadCount, [&](size_t c) -> void {
+        const size_t Population = CellBegin[c + 1] - CellBegin[c];
+        for(size_t n = CellBegin[c]; n < CellBegin[c + 1]; ++n){
+            const size_t i = Order[n];
+            size_t Count = Population;
+            for(size_t k = NeighbourBegin[c]; (k < NeighbourBegin[c + 1]) && (Count < MinPts); ++k){
+                const size_t nc = Neighbours[k];
+                for(size_t m = CellBegin[nc]; (m < CellBegin[nc + 1]) && (Count < MinPts); ++m){
+                    if(IsNeighbour(*(Datum[i]), *(Datum[Order[m]]))) ++Count;
+                }
+            }
+            if(MinPts <= Count){
+                IsCore[i] = 1;
+                CellHasCore[c] = 1;
+            }
+        }
+    });
+
+    CoreTimer.Stop();
+
+    //Join cells whose core datum are within Eps of one another. Core datum sharing a cell are always joined.
+    ClusteringStatsPhaseTimer FormTimer(Stats, "form clusters");
+    ConcurrentDisjointSets Sets(CellCount);
+    ParallelForEachIndex(CellCount, ThreadCount, [&](size_t c) -> void {
+        if(!CellHasCore[c]) return;
+        for(size_t k = NeighbourBegin[c]; k < NeighbourBegin[c + 1]; ++k){
+            const size_t nc = Neighbours[k];
+            if((nc < c) || !CellHasCore[nc] || Sets.SameSet(c, nc)) continue;
+
+            bool Connected = false;
+            for(size_t n = CellBegin[c]; (n < CellBegin[c + 1]) && !Connected; ++n){
+                const size_t i = Order[n];
+                if(!IsCore[i]) continue;
+                for(size_t m = CellBegin[nc]; (m < CellBegin[nc + 1]) && !Connected; ++m){
+                    const size_t j = Order[m];
+                    if(IsCore[j] && IsNeighbour(*(Datum[i]), *(Datum[j]))) Connected = true;
+                }
+            }
+            if(Connected) Sets.Union(c, nc);
+        }
+    });
+
+    //Number the clusters in order of their first core datum.
+    uint64_t ClusterCount = 0;
+    {
+        std::vector<ClusterID_t> RootLabels(CellCount, ClusterID_t(ClusterID_t::Unclassified));
+        auto WorkingCID = ClusterID_t().NextValidClusterID();
+        bool Used = false;
+        for(size_t i = 0; i < N; ++i){
+            if(!IsCore[i]) continue;
+            const size_t r = Sets.Find(CellOf[i]);
+            if(RootLabels[r].IsUnclassified()){
+                if(Used) WorkingCID = WorkingCID.NextValidClusterID();
+                RootLabels[r] = WorkingCID;
+                Used = true;
+                ++ClusterCount;
+            }
+            Labels[i] = RootLabels[r];
+        }
+    }
+
+    //Attach border datum to the lowest-numbered cluster of any core datum within Eps.
+    ParallelForEachIndex(N, ThreadCount, [&](size_t i) -> void {
+        if(IsCore[i]) return;
+        const size_t c = CellOf[i];
+        ClusterID_t Best(ClusterID_t::Noise);
+        auto Consider = [&](size_t j) -> void {
+            if(IsCore[j] && (!Best.IsRegular() || (Labels[j] < Best))) Best = Labels[j];
+        };
+        for(size_t n = CellBegin[c]; n < CellBegin[c + 1]; ++n) Consider(Order[n]);
+        for(size_t k = NeighbourBegin[c]; k < NeighbourBegin[c + 1]; ++k){
+            const size_t nc = Neighbours[k];
+            if(!CellHasCore[nc]) continue;
+            for(size_t m = CellBegin[nc]; m < CellBegin[nc + 1]; ++m){
+                const size_t j = Order[m];
+                if(IsCore[j] && IsNeighbour(*(Datum[i]), *(Datum[j]))) Consider(j);
+            }
+        }
+        Labels[i] = Best;
+    });
+    FormTimer.Stop();
+
+    if(Stats != nullptr){
+        Stats->AddClassification(N, std::count(IsCore.begin(), IsCore.end(), 1),
+                                 std::count_if(Labels.begin(), Labels.end(),
+                                               [](const ClusterID_t &L) -> bool { return L.IsNoise(); }),
+                                 ClusterCount);
+    }
+    return Labels;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void DBSCANGrid( RTree_t & RTree,
+                 typename ClusteringDatum_t::DistanceType_ Eps,
+                 size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                 size_t ThreadCount = 1,
+                 ClusteringStats *Stats = nullptr ){
+
+    // This routine is an exact, grid-based implementation of DBSCAN. It accepts the same parameters and produces
+    //   the same clustering as DBSCAN(), but replaces most R*-tree queries with lookups in a uniform grid of
+    //   hyper-cubes with side Eps/sqrt(D) (for the default Euclidean metric). It is selected automatically by DBSCAN()
+    //   when the user specifies SpatialQueryTechnique::UseGrid, but can also be called directly.
+    //
+    // Since every pair of datum sharing a cell are within Eps of one another:
+    //   - every datum in a cell holding at least MinPts datum is a core datum, so no distance checks are needed,
+    //   - all core datum in a cell belong to the same cluster, so clusters are formed by joining whole cells, and
+    //   - only a small, fixed stencil of neighbouring cells ever needs to be examined.
+    // For dense data this makes the routine close to linear in the number of datum.
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will be modified in-place. The tree
+    //              is only used to enumerate the datum and to hold the resulting ClusterIDs.
+    // 2. Eps --> DBSCAN algorithm parameter. See DBSCAN(). Must be positive.
+    // 3. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. ThreadCount --> The number of threads to use, including the calling thread.
+    // 5. Stats --> If provided, instrumentation is recorded. See ClusteringStats.
+    //
+    // The distance metric can be changed via the DistanceMetric_t template parameter. See DBSCAN().
+    //
+    // NOTE: This approach is best suited to low-dimensional (1D-3D) data. The number of cells that must be examined
+    //       around each cell grows exponentially with dimension (e.g., 5^3 - 1 = 124 cells in 3D), so for higher
+    //       dimensions the R*-tree is generally a better choice. Memory usage is a few machine words per datum.
+    //
+    // NOTE: Core and noise labels are identical to DBSCAN(). Border datum reachable from multiple clusters are
+    //       assigned to the lowest-numbered cluster. See the note in DBSCANParallel().
+    //
+
+    std::vector<const ClusteringDatum_t *> Datum;
+    Datum.reserve(RTree.size());
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&Datum](const typename RTree_t::const_query_iterator &it) -> void {
+        Datum.push_back( std::addressof(*it) );
+    });
+
+    const auto Labels = DBSCANGridLabels<ClusteringDatum_t, DistanceMetric_t>(Datum, Eps, MinPts, ThreadCount, Stats);
+    for(size_t i = 0; i < Datum.size(); ++i){
+        const_cast<ClusteringDatum_t &>(*(Datum[i])).CID = Labels[i];
+    }
+    return;
+}
+
+#endif //YGOR_CLUSTERING_DBSCANGRID_HPP
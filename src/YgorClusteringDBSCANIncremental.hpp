@@ -0,0 +1,542 @@
+
+#ifndef YGOR_CLUSTERING_DBSCANINCREMENTAL_HPP
+#define YGOR_CLUSTERING_DBSCANINCREMENTAL_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <type_traits>
+#include <array>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+#include "YgorClusteringDBSCANParallel.hpp"
+
+
+//This class maintains a DBSCAN clustering of the datum in an R*-tree while datum are inserted and removed. It is an
+// implementation of the 1998 conference proceedings article "Incremental Clustering for Mining in a Data Warehousing
+// Environment" by Ester, Kriegel, Sander, Wimmer, and Xu.
+//
+// Eps and MinPts are fixed when the object is created, at which point the tree is clustered once with DBSCAN(). Each
+// insert() or remove() then only revisits the Eps-neighbourhood of the changed datum and of the datum whose core
+// status it changed. Clusters are created, absorb datum, merge, split, and vanish as needed.
+//
+// After every update the clustering is equivalent to re-running DBSCAN() on the whole tree: the same datum are
+// noise, the same datum are core datum, and core datum are grouped into the same clusters. Border datum are assigned
+// to one of the clusters they border (which one is ambiguous in DBSCAN itself), and cluster numbers are not
+// renumbered, so they can differ from a fresh run. New clusters are given previously unused numbers.
+//
+// The number of datum within Eps of every distinct location is cached, so core status is known without a query.
+// A merge relabels the smaller clusters, walking them with one query per core datum. A potential split walks the
+// pieces in lockstep, so the cost is bounded by the size of the smaller pieces.
+//
+// NOTE: The R*-tree must only be modified through this object while it is in use.
+//
+// NOTE: Removal follows the R*-tree, which treats datum with identical coordinates as interchangeable. If several
+//       datum share coordinates, any one of them may be removed.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+class DBSCANIncremental {
+    public:
+        typedef typename ClusteringDatum_t::SpatialType_ SpatialType_;
+        static_assert(std::is_floating_point<SpatialType_>::value,
+                      "DBSCANIncremental requires floating-point coordinates. See ClusteringDistanceType.");
+        typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+        typedef std::array<SpatialType_, ClusteringDatum_t::SpatialDimensionCount_> Location_t;
+
+    private:
+        struct LocationHash {
+            size_t operator()(const Location_t &L) const {
+                size_t h = 0;
+                for(const auto &x : L) h ^= std::hash<SpatialType_>()(x) + 0x9e3779b9 + (h << 6) + (h >> 2);
+                return h;
+            }
+        };
+
+        struct LocationInfo {
+            size_t Count;        //The number of datum within Eps of this location.
+            size_t Multiplicity; //The number of datum at this location.
+        };
+
+        typedef typename ClusteringDatum_t::ClusterIDType_ RawCID_t;
+
+        RTree_t &RTree;
+        SpatialType_ Eps;
+        size_t MinPts;
+        SpatialQueryTechnique Technique;
+
+        std::unordered_map<Location_t, LocationInfo, LocationHash> Locations;
+        std::unordered_map<RawCID_t, size_t> ClusterSizes; //Including border datum.
+        ClusterID_t NextCID;
+
+        std::vector<Location_t> Keys; //Scratch buffer.
+
+        const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
+                                                " This point is missing, indicating numerical stability issues"
+                                                " or logical errors in the spatial indexing approach.";
+
+        static Location_t LocationOf(const ClusteringDatum_t &P){
+            Location_t L;
+            //Adding zero maps -0 to +0, which compare equal but hash differently.
+            for(size_t d = 0; d < L.size(); ++d) L[d] = P.Coordinates[d] + static_cast<SpatialType_>(0);
+            return L;
+        }
+
+        void Gather(const ClusteringDatum_t &P, std::vector<const ClusteringDatum_t *> &Out) const {
+            Out.clear();
+            GatherDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(this->RTree, P, this->Eps,
+                                                                                this->Technique, Out);
+            return;
+        }
+
+        //The distinct locations of a set of datum, sorted.
+        void DistinctLocations(const std::vector<const ClusteringDatum_t *> &In, std::vector<Location_t> &Out) const {
+            Out.clear();
+            for(const auto *r : In) Out.push_back( LocationOf(*r) );
+            std::sort(Out.begin(), Out.end());
+            Out.erase(std::unique(Out.begin(), Out.end()), Out.end());
+            return;
+        }
+
+        ClusterID_t AllocateClusterID(void){
+            const ClusterID_t out = this->NextCID;
+            this->NextCID = this->NextCID.NextValidClusterID();
+            return out;
+        }
+
+        void Relabel(const ClusteringDatum_t &P, ClusterID_t L){
+            auto &CID = const_cast<ClusteringDatum_t &>(P).CID;
+            if(CID.IsRegular()){
+                auto it = this->ClusterSizes.find(CID.Raw);
+                if(--(it->second) == 0) this->ClusterSizes.erase(it);
+            }
+            if(L.IsRegular()) ++(this->ClusterSizes[L.Raw]);
+            CID = L;
+            return;
+        }
+
+        size_t ClusterSize(ClusterID_t L) const {
+            const auto it = this->ClusterSizes.find(L.Raw);
+            return (it == this->ClusterSizes.end()) ? 0 : it->second;
+        }
+
+        //Relabels every datum of cluster 'From' that can be reached from core datum 'Seed' through core datum of
+        // 'From'. Used for merges, and for splits once a piece is known to be disconnected from the rest.
+        void RelabelConnected(const ClusteringDatum_t &Seed, ClusterID_t From, ClusterID_t To){
+            std::vector<const ClusteringDatum_t *> Queue;
+            std::vector<const ClusteringDatum_t *> Neighbours;
+            this->Relabel(Seed, To);
+            Queue.push_back( std::addressof(Seed) );
+            for(size_t Head = 0; Head < Queue.size(); ++Head){
+                this->Gather(*(Queue[Head]), Neighbours);
+                for(const auto *r : Neighbours){
+                    if(!(r->CID == From)) continue;
+                    this->Relabel(*r, To);
+                    if(this->IsCore(*r)) Queue.push_back(r);
+                }
+            }
+            return;
+        }
+
+        //Determines whether the given core datum of cluster K are still connected through core datum of K, and
+        // relabels all but one of the pieces if they are not.
+        //
+        // One breadth-first search is started from each seed, and the searches take turns expanding a single datum.
+        // Searches that meet are combined. When a search runs out of datum, it has found a complete piece. The work
+        // stops once a single search remains, so the largest piece is never walked in full.
+        void SplitIfDisconnected(ClusterID_t K, const std::vector<const ClusteringDatum_t *> &Seeds){
+            const size_t M = Seeds.size();
+            if(M < 2) return;
+
+            std::vector<size_t> Parent(M);
+            for(size_t i = 0; i < M; ++i) Parent[i] = i;
+            auto Find = [&](size_t i) -> size_t {
+                while(Parent[i] != i) i = Parent[i] = Parent[Parent[i]];
+                return i;
+            };
+
+            std::unordered_map<const ClusteringDatum_t *, size_t> Owner;
+            std::vector<std::vector<const ClusteringDatum_t *>> Queue(M);
+            std::vector<size_t> Head(M, 0);
+            std::vector<uint8_t> Finished(M, 0);
+            size_t Active = 0;
+            for(size_t i = 0; i < M; ++i){
+                auto it = Owner.find(Seeds[i]);
+                if(it != Owner.end()){
+                    Parent[i] = Find(it->second);
+                    continue;
+                }
+                Owner[Seeds[i]] = i;
+                Queue[i].push_back(Seeds[i]);
+                ++Active;
+            }
+
+            std::vector<size_t> Pieces; //Completed searches, in order of completion.
+            std::vector<const ClusteringDatum_t *> Neighbours;
+            while(1 < Active){
+                for(size_t i = 0; (i < M) && (1 < Active); ++i){
+                    if((Find(i) != i) || Finished[i]) continue;
+                    if(Head[i] == Queue[i].size()){
+                        Finished[i] = 1;
+                        Pieces.push_back(i);
+                        --Active;
+                        continue;
+                    }
+                    const ClusteringDatum_t &Q = *(Queue[i][Head[i]++]);
+                    this->Gather(Q, Neighbours);
+                    for(const auto *r : Neighbours){
+                        if(!(r->CID == K) || !this->IsCore(*r)) continue;
+                        auto it = Owner.find(r);
+                        if(it == Owner.end()){
+                            Owner[r] = i;
+                            Queue[i].push_back(r);
+                            continue;
+                        }
+                        const size_t j = Find(it->second);
+                        if(j == i) continue;
+
+                        //The searches met. Fold the other search into this one.
+                        Parent[j] = i;
+                        Queue[i].insert(Queue[i].end(), Queue[j].begin() + Head[j], Queue[j].end());
+                        Queue[j].clear();
+                        Head[j] = 0;
+                        --Active;
+                        if(Active < 2) break;
+                    }
+                }
+            }
+
+            //The remaining search keeps the original label.
+            for(const size_t i : Pieces){
+                this->RelabelConnected(*(Seeds[i]), K, this->AllocateClusterID());
+            }
+            return;
+        }
+
+        //Ensures a non-core datum is labeled with the cluster of a core datum within Eps, or as noise.
+        void RelabelNonCore(const ClusteringDatum_t &P){
+            std::vector<const ClusteringDatum_t *> Neighbours;
+            this->Gather(P, Neighbours);
+            ClusterID_t L(ClusterID_t::Noise);
+            for(const auto *r : Neighbours){
+                if(!this->IsCore(*r)) continue;
+                if(r->CID == P.CID) return;
+                if(L.IsNoise()) L = r->CID;
+            }
+            this->Relabel(P, L);
+            return;
+        }
+
+    public:
+        DBSCANIncremental( RTree_t & InRTree,
+                           SpatialType_ InEps,
+                           size_t InMinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                           SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+                           size_t ThreadCount = DefaultClusteringThreadCount() )
+                : RTree(InRTree), Eps(InEps), MinPts(InMinPts), Technique(UsersSpatialQueryTechnique) {
+
+            // User parameters:
+            //
+            // 1. RTree --> The R*-tree already loaded with the data to be clustered (possibly empty). The CIDs will
+            //              be modified in-place by this object from now on.
+            // 2. Eps --> DBSCAN algorithm parameter. See DBSCAN().
+            // 3. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+            // 4. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+            //                              UseGrid is not supported, since neighbourhoods need to be enumerated.
+            // 5. ThreadCount --> The number of threads used to count the initial neighbourhoods.
+            //
+            if(UsersSpatialQueryTechnique == SpatialQueryTechnique::UseGrid){
+                throw std::runtime_error("Incremental DBSCAN requires an R*-tree spatial query technique.");
+            }
+            if(this->MinPts == 0) throw std::runtime_error("Parameter 'MinPts' must be >= 1.");
+
+            DBSCANParallel<RTree_t, ClusteringDatum_t, DistanceMetric_t>(this->RTree, this->Eps, this->MinPts,
+                                                                          this->Technique, ThreadCount);
+
+            const RTree_t &ConstRTree = this->RTree;
+            const RTreeDatumIndex<RTree_t, ClusteringDatum_t> Index(ConstRTree);
+            const size_t N = Index.size();
+            std::vector<size_t> Counts(N, 0);
+            ParallelForEachIndex(N, ThreadCount, [&](size_t i) -> void {
+                size_t Count = 0;
+                OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(ConstRTree, *(Index.Datum[i]),
+                    this->Eps, this->Technique, [&Count](const ClusteringDatum_t &) -> void { ++Count; });
+                Counts[i] = Count;
+            });
+
+            this->NextCID = ClusterID_t().NextValidClusterID();
+            this->Locations.reserve(N);
+            for(size_t i = 0; i < N; ++i){
+                const auto &P = *(Index.Datum[i]);
+                auto &Info = this->Locations[ LocationOf(P) ];
+                Info.Count = Counts[i];
+                ++(Info.Multiplicity);
+                if(P.CID.IsRegular()){
+                    ++(this->ClusterSizes[P.CID.Raw]);
+                    if(!(P.CID < this->NextCID)) this->NextCID = P.CID.NextValidClusterID();
+                }
+            }
+        }
+
+        SpatialType_ GetEps(void) const {
+            return this->Eps;
+        }
+
+        size_t GetMinPts(void) const {
+            return this->MinPts;
+        }
+
+        //Whether the datum (which must be a member of the R*-tree) is a core datum.
+        bool IsCore(const ClusteringDatum_t &P) const {
+            const auto it = this->Locations.find( LocationOf(P) );
+            return (it != this->Locations.end()) && (this->MinPts <= it->second.Count);
+        }
+
+        //Inserts a datum into the R*-tree and updates the clustering. The provided CID is ignored.
+        void insert(const ClusteringDatum_t &In){
+            ClusteringDatum_t Copy(In);
+            Copy.CID = ClusterID_t(ClusterID_t::Unclassified);
+            this->RTree.insert(Copy);
+
+            //Locate the new datum. Every other datum in the tree is already classified.
+            const Location_t Key = LocationOf(Copy);
+            std::vector<const ClusteringDatum_t *> Neighbours;
+            this->Gather(Copy, Neighbours);
+            const ClusteringDatum_t *P = nullptr;
+            for(const auto *r : Neighbours){
+                if(r->CID.IsUnclassified() && (LocationOf(*r) == Key)) P = r;
+            }
+            if(P == nullptr) throw std::runtime_error(ThrowSelfPointCheck);
+
+            //Every location within Eps gains a neighbour. Those reaching MinPts exactly have just become core.
+            this->DistinctLocations(Neighbours, this->Keys);
+            std::unordered_set<Location_t, LocationHash> NewlyCore;
+            for(const auto &k : this->Keys){
+                auto it = this->Locations.find(k);
+                if(it == this->Locations.end()){
+                    it = this->Locations.emplace(k, LocationInfo{ Neighbours.size(), 0 }).first;
+                    if(this->MinPts <= it->second.Count) NewlyCore.insert(k);
+                }else if(++(it->second.Count) == this->MinPts){
+                    NewlyCore.insert(k);
+                }
+            }
+            ++(this->Locations[Key].Multiplicity);
+
+            //The new datum is also a new vertex in the core graph if it is core, even at an existing core location.
+            std::vector<const ClusteringDatum_t *> NewCores;
+            for(const auto *r : Neighbours){
+                if((r == P) ? this->IsCore(*r) : (NewlyCore.count(LocationOf(*r)) != 0)) NewCores.push_back(r);
+            }
+
+            if(NewCores.empty()){
+                //Nothing else changed. The new datum is either a border datum or noise.
+                ClusterID_t L(ClusterID_t::Noise);
+                for(const auto *r : Neighbours){
+                    if(this->IsCore(*r)){
+                        L = r->CID;
+                        break;
+                    }
+                }
+                this->Relabel(*P, L);
+                return;
+            }
+
+            //Group the new core datum with each other and with the existing clusters they touch. Each group becomes
+            // one cluster: a new one, an existing one absorbing datum, or several existing ones merging.
+            const size_t M = NewCores.size();
+            std::unordered_map<const ClusteringDatum_t *, size_t> NewCoreIndex;
+            for(size_t i = 0; i < M; ++i) NewCoreIndex[NewCores[i]] = i;
+
+            std::vector<size_t> Parent(M);
+            for(size_t i = 0; i < M; ++i) Parent[i] = i;
+            std::unordered_map<RawCID_t, size_t> ClusterIndex;
+            std::vector<const ClusteringDatum_t *> ClusterSeed; //An existing core datum of each touched cluster.
+            auto Find = [&](size_t i) -> size_t {
+                while(Parent[i] != i) i = Parent[i] = Parent[Parent[i]];
+                return i;
+            };
+            auto Union = [&](size_t a, size_t b) -> void {
+                a = Find(a);
+                b = Find(b);
+                if(a != b) Parent[std::max(a, b)] = std::min(a, b);
+                return;
+            };
+
+            std::vector<std::vector<const ClusteringDatum_t *>> NewCoreNeighbours(M);
+            for(size_t i = 0; i < M; ++i){
+                this->Gather(*(NewCores[i]), NewCoreNeighbours[i]);
+                for(const auto *r : NewCoreNeighbours[i]){
+                    if(!this->IsCore(*r)) continue;
+                    const auto n = NewCoreIndex.find(r);
+                    if(n != NewCoreIndex.end()){
+                        Union(i, n->second);
+                        continue;
+                    }
+                    auto c = ClusterIndex.find(r->CID.Raw);
+                    if(c == ClusterIndex.end()){
+                        c = ClusterIndex.emplace(r->CID.Raw, Parent.size()).first;
+                        Parent.push_back(Parent.size());
+                        ClusterSeed.push_back(r);
+                    }
+                    Union(i, c->second);
+                }
+            }
+
+            //Within each group, the largest existing cluster keeps its label and absorbs the others.
+            std::unordered_map<size_t, ClusterID_t> GroupLabel;
+            std::vector<std::pair<RawCID_t, size_t>> Touched(ClusterIndex.begin(), ClusterIndex.end());
+            std::sort(Touched.begin(), Touched.end(),
+                      [&](const std::pair<RawCID_t, size_t> &L, const std::pair<RawCID_t, size_t> &R) -> bool {
+                          const size_t SL = this->ClusterSize(ClusterID_t(L.first));
+                          const size_t SR = this->ClusterSize(ClusterID_t(R.first));
+                          return (SL != SR) ? (SR < SL) : (L.first < R.first);
+                      });
+            for(const auto &t : Touched){
+                const size_t g = Find(t.second);
+                const auto it = GroupLabel.find(g);
+                if(it == GroupLabel.end()){
+                    GroupLabel.emplace(g, ClusterID_t(t.first));
+                }else{
+                    this->RelabelConnected(*(ClusterSeed[t.second - M]), ClusterID_t(t.first), it->second);
+                }
+            }
+
+            for(size_t i = 0; i < M; ++i){
+                const size_t g = Find(i);
+                auto it = GroupLabel.find(g);
+                if(it == GroupLabel.end()) it = GroupLabel.emplace(g, this->AllocateClusterID()).first;
+                const ClusterID_t L = it->second;
+                this->Relabel(*(NewCores[i]), L);
+                for(const auto *r : NewCoreNeighbours[i]){
+                    if(!r->CID.IsRegular()) this->Relabel(*r, L);
+                }
+            }
+            return;
+        }
+
+        //Removes a datum from the R*-tree and updates the clustering. Returns false if no datum was found at the
+        // provided coordinates.
+        bool remove(const ClusteringDatum_t &In){
+            const Location_t Key = LocationOf(In);
+            const auto Found = this->Locations.find(Key);
+            if(Found == this->Locations.end()) return false;
+            const bool WasCore = (this->MinPts <= Found->second.Count);
+
+            //Datum at the same location are indistinguishable to the R*-tree, so the label of the removed datum is
+            // found by comparing labels before and after.
+            std::vector<const ClusteringDatum_t *> Neighbours;
+            std::vector<RawCID_t> Before, After;
+            this->Gather(In, Neighbours);
+            for(const auto *r : Neighbours) if(LocationOf(*r) == Key) Before.push_back(r->CID.Raw);
+
+            if(this->RTree.remove(In) == 0) return false;
+
+            this->Gather(In, Neighbours);
+            for(const auto *r : Neighbours) if(LocationOf(*r) == Key) After.push_back(r->CID.Raw);
+            std::sort(Before.begin(), Before.end());
+            std::sort(After.begin(), After.end());
+            std::vector<RawCID_t> Removed;
+            std::set_difference(Before.begin(), Before.end(), After.begin(), After.end(), std::back_inserter(Removed));
+            if(Removed.size() != 1) throw std::runtime_error("Unable to identify the removed datum.");
+            if(ClusterID_t(Removed.front()).IsRegular()){
+                auto it = this->ClusterSizes.find(Removed.front());
+                if(--(it->second) == 0) this->ClusterSizes.erase(it);
+            }
+
+            //Every location within Eps loses a neighbour. Those falling just below MinPts are no longer core.
+            this->DistinctLocations(Neighbours, this->Keys);
+            std::unordered_set<Location_t, LocationHash> Demoted;
+            for(const auto &k : this->Keys){
+                auto &Info = this->Locations[k];
+                if(--(Info.Count) == (this->MinPts - 1)) Demoted.insert(k);
+            }
+            {
+                auto it = this->Locations.find(Key);
+                if(--(it->second.Multiplicity) == 0) this->Locations.erase(it);
+            }
+            if(!WasCore && Demoted.empty()) return true;
+
+            //Core datum that neighboured a lost core datum are the seeds of a potential split. Non-core datum that
+            // did may have lost their only core neighbour.
+            std::vector<const ClusteringDatum_t *> Seeds;
+            std::vector<const ClusteringDatum_t *> NonCore;
+            std::vector<const ClusteringDatum_t *> Lost;
+            for(const auto *r : Neighbours){
+                if(Demoted.count(LocationOf(*r)) != 0) Lost.push_back(r);
+            }
+            auto Sort = [&](const ClusteringDatum_t *r) -> void {
+                if(this->IsCore(*r)){
+                    Seeds.push_back(r);
+                }else{
+                    NonCore.push_back(r);
+                }
+            };
+            if(WasCore) for(const auto *r : Neighbours) Sort(r);
+            std::vector<const ClusteringDatum_t *> LostNeighbours;
+            for(const auto *l : Lost){
+                NonCore.push_back(l);
+                this->Gather(*l, LostNeighbours);
+                for(const auto *r : LostNeighbours) Sort(r);
+            }
+
+            //Check each affected cluster for a split. Seeds sharing a location are trivially connected.
+            std::sort(Seeds.begin(), Seeds.end(), [](const ClusteringDatum_t *L, const ClusteringDatum_t *R) -> bool {
+                return (L->CID.Raw != R->CID.Raw) ? (L->CID.Raw < R->CID.Raw) : (L->Coordinates < R->Coordinates);
+            });
+            Seeds.erase(std::unique(Seeds.begin(), Seeds.end(),
+                                    [](const ClusteringDatum_t *L, const ClusteringDatum_t *R) -> bool {
+                                        return (L->CID.Raw == R->CID.Raw) && (L->Coordinates == R->Coordinates);
+                                    }), Seeds.end());
+            std::vector<const ClusteringDatum_t *> ClusterSeeds;
+            for(size_t i = 0; i < Seeds.size(); ){
+                size_t j = i;
+                ClusterSeeds.clear();
+                while((j < Seeds.size()) && (Seeds[j]->CID.Raw == Seeds[i]->CID.Raw)) ClusterSeeds.push_back(Seeds[j++]);
+                this->SplitIfDisconnected(Seeds[i]->CID, ClusterSeeds);
+                i = j;
+            }
+
+            std::sort(NonCore.begin(), NonCore.end());
+            NonCore.erase(std::unique(NonCore.begin(), NonCore.end()), NonCore.end());
+            for(const auto *r : NonCore) this->RelabelNonCore(*r);
+            return true;
+        }
+};
+
+#endif //YGOR_CLUSTERING_DBSCANINCREMENTAL_HPP
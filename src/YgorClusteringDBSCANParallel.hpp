@@ -0,0 +1,319 @@
+
+#ifndef YGOR_CLUSTERING_DBSCANPARALLEL_HPP
+#define YGOR_CLUSTERING_DBSCANPARALLEL_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <atomic>
+#include <thread>
+#include <future>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringOptions.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void DBSCANParallel( const RTree_t & RTree,
+                     std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > & Labels,
+                     typename ClusteringDatum_t::DistanceType_ Eps,
+                     size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                     SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+                     size_t ThreadCount = DefaultClusteringThreadCount(),
+                     const DBSCANOptions *Options = nullptr ){
+
+    // This routine is a multi-threaded variant of DBSCAN(). It accepts the same parameters and produces the same
+    //   clustering, but performs the expensive spatial queries concurrently against the (read-only) R*-tree.
+    //
+    // The routine works in several phases:
+    //   1. Every datum's Eps-neighbourhood is counted concurrently to decide which datum are 'core' datum. Counting
+    //      stops at MinPts. See CountDatumWithinRadius().
+    //   2. Core datum are concurrently joined with all core datum in their Eps-neighbourhood using a lock-free
+    //      union-find. The resulting disjoint sets are exactly the DBSCAN clusters.
+    //   3. Clusters are numbered in the order that DBSCAN() would discover them, i.e., by the first core datum
+    //      encountered while traversing the R*-tree.
+    //   4. Non-core datum are concurrently assigned to the cluster of a neighbouring core datum, if there is one,
+    //      or marked as noise.
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will not be modified.
+    // 2. Labels --> Resized to the number of datum in the R*-tree and overwritten with the results, one per datum
+    //               in R*-tree traversal order. See the const overload of DBSCAN().
+    // 3. Eps --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 5. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+    // 6. ThreadCount --> The number of threads to use, including the calling thread. Defaults to the number of
+    //                    hardware threads available.
+    // 7. Options --> If provided, progress is reported and cancellation is honoured. Progress callbacks may be
+    //                invoked from any of the worker threads. A space-filling curve traversal order can also be
+    //                selected; it does not change the results. See DBSCANOptions.
+    //
+    // The distance metric can be changed via the DistanceMetric_t template parameter. See DBSCAN().
+    //
+    // NOTE: Core and noise labels are identical to DBSCAN(), as are the cluster memberships of core datum. A
+    //       border datum (i.e., a non-core datum within Eps of core datum belonging to two or more clusters) is
+    //       assigned to the lowest-numbered of those clusters. DBSCAN() assigns such datum based on the order
+    //       clusters happen to be expanded, so a handful of border datum may legitimately differ. This ambiguity
+    //       is inherent to the DBSCAN algorithm.
+    //
+    // NOTE: Memory usage is a handful of machine words per datum in addition to the R*-tree itself.
+    //
+    // NOTE: 1D datum are clustered by sorting instead (see DBSCANSortAndSweepLabels()) unless UseGrid is specified.
+    //
+
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+
+    const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
+                                            " This point is missing, indicating numerical stability issues"
+                                            " or logical errors in the spatial indexing approach.";
+
+    const RTree_t &ConstRTree = RTree;
+    const RTreeDatumIndex<RTree_t, ClusteringDatum_t> Index(ConstRTree);
+    const size_t N = Index.size();
+
+    const bool UseGrid = (UsersSpatialQueryTechnique == SpatialQueryTechnique::UseGrid);
+    if(UseGrid || (ClusteringDatum_t::SpatialDimensionCount_ == 1)){
+        ClusteringProgressMonitor Monitor(Options, N);
+        Monitor.ThrowIfCancelled();
+        ClusteringStats RunStats;
+        ClusteringStats *RunStatsPtr = Monitor.IsActive() ? &RunStats : nullptr;
+        if(UseGrid){
+            Labels = DBSCANGridLabels<ClusteringDatum_t, DistanceMetric_t>(Index.Datum, Eps, MinPts, ThreadCount,
+                                                                           RunStatsPtr);
+        }else if constexpr(ClusteringDatum_t::SpatialDimensionCount_ == 1){
+            Labels = DBSCANSortAndSweepLabels<ClusteringDatum_t, DistanceMetric_t>(Index.Datum, Eps, MinPts,
+                                                                                   ThreadCount, RunStatsPtr);
+        }
+        Monitor.Finish(N, RunStats.ClusterCount);
+        return;
+    }
+
+    //Each phase visits every datum once, so progress is measured in datum visits over all three concurrent phases.
+    // Datum are only considered classified once the final phase reaches them.
+    ClusteringProgressMonitor Monitor(Options, N, 3 * N);
+    Monitor.ThrowIfCancelled();
+    std::atomic<size_t> Visited(0);
+    size_t ClustersFound = 0;
+    auto Checkpoint = [&](void) -> void {
+        if(!Monitor.IsActive()) return;
+        const size_t Done = ++Visited;
+        Monitor.Checkpoint(Done, (2 * N < Done) ? (Done - 2 * N) : 0, ClustersFound);
+    };
+
+    //The query phases visit datum in the requested traversal order. Clusters are still numbered in R*-tree order,
+    // so the order only affects which parts of the R*-tree each thread touches, not the results.
+    std::vector<size_t> VisitOrder;
+    if( (Options != nullptr)
+    &&  (Options->TraversalOrder != ClusteringTraversalOrder::RTree) ){
+        constexpr size_t D = ClusteringDatum_t::SpatialDimensionCount_;
+        std::array<double, D> Lower;
+        std::array<double, D> Upper;
+        Lower.fill( std::numeric_limits<double>::infinity() );
+        Upper.fill( -std::numeric_limits<double>::infinity() );
+        for(const auto *P : Index.Datum){
+            for(size_t d = 0; d < D; ++d){
+                Lower[d] = std::min(Lower[d], static_cast<double>(P->Coordinates[d]));
+                Upper[d] = std::max(Upper[d], static_cast<double>(P->Coordinates[d]));
+            }
+        }
+        std::vector<const ClusteringDatum_t *> Sorted(Index.Datum);
+        SortAlongSpaceFillingCurve<D>(Sorted, SpaceFillingCurveKeyer<D>(Options->TraversalOrder, Lower, Upper),
+                                      ThreadCount);
+        VisitOrder.resize(N);
+        ParallelForEachIndex(N, ThreadCount, [&](size_t k) -> void {
+            VisitOrder[k] = Index.IndexOf(*(Sorted[k]));
+        }, 4096);
+    }
+    const auto Visit = [&](size_t k) -> size_t {
+        return VisitOrder.empty() ? k : VisitOrder[k];
+    };
+
+    //Phase 1: identify core datum. Only the number of neighbours matters here, so a radius query is used regardless
+    // of the requested technique, and it stops as soon as MinPts neighbours have been found.
+    std::vector<uint8_t> IsCore(N, 0);
+    ParallelForEachIndex(N, ThreadCount, [&](size_t k) -> void {
+        const size_t i = Visit(k);
+        Checkpoint();
+        const ClusteringDatum_t &P = *(Index.Datum[i]);
+        size_t Count = 0;
+        bool FoundSelf = false;
+        const bool Exhausted = VisitDatumWithinRadius<RTree_t, ClusteringDatum_t, DistanceMetric_t>(ConstRTree,
+            P, Eps,
+            [&](const ClusteringDatum_t &nearby) -> bool {
+                if(std::addressof(nearby) == std::addressof(P)) FoundSelf = true;
+                return (++Count < MinPts);
+            });
+        //The self point can only be confirmed missing if the whole neighbourhood was visited.
+        if(Exhausted && !FoundSelf) throw std::runtime_error(ThrowSelfPointCheck);
+        IsCore[i] = (MinPts <= Count) ? 1 : 0;
+    });
+
+    //Phase 2: join directly density-reachable core datum.
+    ConcurrentDisjointSets Sets(N);
+    ParallelForEachIndex(N, ThreadCount, [&](size_t k) -> void {
+        const size_t i = Visit(k);
+        Checkpoint();
+        if(!IsCore[i]) return;
+        OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(ConstRTree, *(Index.Datum[i]), Eps,
+            UsersSpatialQueryTechnique,
+            [&](const ClusteringDatum_t &nearby) -> void {
+                const size_t j = Index.IndexOf(nearby);
+                //Each pair is encountered twice, so only join in one direction.
+                if((i < j) && IsCore[j]) Sets.Union(i, j);
+            });
+    });
+
+    //Phase 3: number the clusters. Set representatives are the smallest index in each set, so the representative
+    // is also the first core datum that the serial DBSCAN() would have encountered for each cluster.
+    Labels.assign(N, ClusterID_t(ClusterID_t::Noise));
+    {
+        auto WorkingCID = ClusterID_t().NextValidClusterID();
+        bool Used = false;
+        for(size_t i = 0; i < N; ++i){
+            if(!IsCore[i]) continue;
+            const size_t r = Sets.Find(i);
+            if(r == i){
+                if(Used) WorkingCID = WorkingCID.NextValidClusterID();
+                Labels[i] = WorkingCID;
+                Used = true;
+                ++ClustersFound;
+            }else{
+                Labels[i] = Labels[r]; //Representative always precedes the other members.
+            }
+        }
+    }
+
+    //Phase 4: attach border datum to the lowest-numbered neighbouring cluster.
+    ParallelForEachIndex(N, ThreadCount, [&](size_t k) -> void {
+        const size_t i = Visit(k);
+        Checkpoint();
+        if(IsCore[i]) return;
+        ClusterID_t Best(ClusterID_t::Noise);
+        OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(ConstRTree, *(Index.Datum[i]), Eps,
+            UsersSpatialQueryTechnique,
+            [&](const ClusteringDatum_t &nearby) -> void {
+                const size_t j = Index.IndexOf(nearby);
+                if(!IsCore[j]) return;
+                if(!Best.IsRegular() || (Labels[j] < Best)) Best = Labels[j];
+            });
+        Labels[i] = Best; //Only this thread touches Labels[i], and core labels are no longer written.
+    });
+    Monitor.Finish(N, ClustersFound);
+    return;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void DBSCANParallel( RTree_t & RTree,
+                     typename ClusteringDatum_t::DistanceType_ Eps,
+                     size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                     SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+                     size_t ThreadCount = DefaultClusteringThreadCount(),
+                     const DBSCANOptions *Options = nullptr ){
+
+    // This overload stores the results directly in the datum held by the R*-tree, like DBSCAN() does. See the
+    //   overload above for details.
+    //
+    const RTree_t &ConstRTree = RTree;
+    std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > Labels;
+    DBSCANParallel<RTree_t, ClusteringDatum_t, DistanceMetric_t>(ConstRTree, Labels, Eps, MinPts,
+                                                                  UsersSpatialQueryTechnique, ThreadCount, Options);
+
+    //Write the labels into the R*-tree. Traversal order is stable as long as the tree is not modified.
+    size_t i = 0;
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&](const typename RTree_t::const_query_iterator &it) -> void {
+        const_cast<ClusteringDatum_t &>(*it).CID = Labels[i++];
+    });
+    return;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+std::future< std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > >
+    DBSCANAsync( const RTree_t & RTree,
+                 typename ClusteringDatum_t::DistanceType_ Eps,
+                 size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                 SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+                 DBSCANOptions Options = DBSCANOptions(),
+                 size_t ThreadCount = 1 ){
+
+    // This routine launches DBSCAN on a new thread and immediately returns a future holding the labels, one per
+    //   datum in R*-tree traversal order. See the const overload of DBSCAN().
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It is only read, but it must outlive
+    //              the run and must not be modified until the future is ready.
+    // 2. Eps --> DBSCAN algorithm parameter. See DBSCAN().
+    // 3. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+    // 5. Options --> Progress callback and cancellation token. Keep a copy of Options.Cancellation to cancel the
+    //                run later; the future then throws ClusteringCancelled from get().
+    // 6. ThreadCount --> If more than one, DBSCANParallel() is used with this many threads (including the thread
+    //                    launched here). Otherwise the serial DBSCAN() is used.
+    //
+    // For example, a service can abandon a stale job and reclaim its cores with:
+    //
+    //     DBSCANOptions Options;
+    //     auto Cancellation = Options.Cancellation;
+    //     auto Labels = DBSCANAsync<RTree_t, CDat_t>(rtree, Eps, MinPts, UseWithin, Options, 8);
+    //     ...
+    //     Cancellation.Cancel();
+    //
+    // NOTE: The future's destructor blocks until the run finishes, so cancel before discarding it.
+    //
+    typedef std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > Labels_t;
+    return std::async(std::launch::async, [&RTree, Eps, MinPts, UsersSpatialQueryTechnique,
+                                           Options, ThreadCount](void) -> Labels_t {
+        Labels_t Labels;
+        if(ThreadCount <= 1){
+            DBSCAN<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Labels, Eps, MinPts,
+                                                                  UsersSpatialQueryTechnique, nullptr, &Options);
+        }else{
+            DBSCANParallel<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Labels, Eps, MinPts,
+                                                                          UsersSpatialQueryTechnique, ThreadCount,
+                                                                          &Options);
+        }
+        return Labels;
+    });
+}
+
+#endif //YGOR_CLUSTERING_DBSCANPARALLEL_HPP
@@ -0,0 +1,258 @@
+
+#ifndef YGOR_CLUSTERING_DBSCANSWEEP_HPP
+#define YGOR_CLUSTERING_DBSCANSWEEP_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <type_traits>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+
+
+//This class caches every datum's neighbourhood out to some maximum distance, Eps_max, so that DBSCAN can be
+// re-run for any Eps <= Eps_max and any MinPts without repeating a single spatial query.
+//
+// Neighbourhoods are stored in a compressed sparse row layout: a 32-bit neighbour index and a comparable distance
+// per neighbour, sorted by distance, so the Eps-neighbourhood of a datum is simply a prefix of its cached list.
+// Datum are numbered in R*-tree traversal order (see RTreeDatumIndex), and so are the labels produced.
+//
+// NOTE: Memory usage is proportional to the total number of neighbour pairs within Eps_max. Eps_max should be
+//       chosen no larger than needed; a good upper bound can be read off of DBSCANSortedkDistGraph().
+//
+// NOTE: The cache is invalidated if the R*-tree is modified.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+class DBSCANNeighbourCache {
+    public:
+        typedef typename ClusteringDatum_t::SpatialType_ SpatialType_;
+        static_assert(std::is_floating_point<SpatialType_>::value,
+                      "DBSCANNeighbourCache requires floating-point coordinates. See ClusteringDistanceType.");
+        typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+        typedef uint32_t IndexType_;
+
+    private:
+        SpatialType_ EpsMax;
+        std::vector<size_t> Offsets;         //Datum i's neighbours span [Offsets[i], Offsets[i+1]).
+        std::vector<IndexType_> Neighbours;
+        std::vector<SpatialType_> Distances; //Comparable distances, in ascending order per datum.
+
+    public:
+        DBSCANNeighbourCache( const RTree_t & RTree,
+                              SpatialType_ Eps_max,
+                              SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+                              size_t ThreadCount = DefaultClusteringThreadCount() ) : EpsMax(Eps_max) {
+
+            const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
+                                                    " This point is missing, indicating numerical stability issues"
+                                                    " or logical errors in the spatial indexing approach.";
+
+            const RTreeDatumIndex<RTree_t, ClusteringDatum_t> Index(RTree);
+            const size_t N = Index.size();
+            if(static_cast<size_t>(std::numeric_limits<IndexType_>::max()) < N){
+                throw std::runtime_error("Too many datum to cache neighbourhoods with 32-bit indices.");
+            }
+
+            //Datum are handled in chunks so each chunk can accumulate its neighbourhoods without synchronization.
+            // Chunks are concatenated afterward.
+            constexpr size_t ChunkSize = 256;
+            const size_t ChunkCount = (N + ChunkSize - 1) / ChunkSize;
+            std::vector<std::vector<std::pair<SpatialType_, IndexType_>>> ChunkNeighbours(ChunkCount);
+            std::vector<size_t> Counts(N, 0);
+
+            ParallelForEachIndex(ChunkCount, ThreadCount, [&](size_t c) -> void {
+                auto &Out = ChunkNeighbours[c];
+                const size_t End = std::min(N, (c + 1) * ChunkSize);
+                for(size_t i = c * ChunkSize; i < End; ++i){
+                    const ClusteringDatum_t &P = *(Index.Datum[i]);
+                    const size_t Begin = Out.size();
+                    bool FoundSelf = false;
+                    OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, P, Eps_max,
+                        UsersSpatialQueryTechnique,
+                        [&](const ClusteringDatum_t &nearby) -> void {
+                            if(std::addressof(nearby) == std::addressof(P)) FoundSelf = true;
+                            Out.emplace_back( MetricComparableDistance<DistanceMetric_t>(P, nearby),
+                                              static_cast<IndexType_>(Index.IndexOf(nearby)) );
+                        });
+                    if(!FoundSelf) throw std::runtime_error(ThrowSelfPointCheck);
+                    std::sort(Out.begin() + Begin, Out.end());
+                    Counts[i] = Out.size() - Begin;
+                }
+            }, 1);
+
+            this->Offsets.resize(N + 1, 0);
+            for(size_t i = 0; i < N; ++i) this->Offsets[i + 1] = this->Offsets[i] + Counts[i];
+            this->Neighbours.reserve(this->Offsets[N]);
+            this->Distances.reserve(this->Offsets[N]);
+            for(auto &Out : ChunkNeighbours){
+                for(const auto &p : Out){
+                    this->Distances.push_back(p.first);
+                    this->Neighbours.push_back(p.second);
+                }
+                Out.clear();
+                Out.shrink_to_fit();
+            }
+        }
+
+        size_t size(void) const {
+            return this->Offsets.size() - 1;
+        }
+
+        SpatialType_ MaximumEps(void) const {
+            return this->EpsMax;
+        }
+
+        //The number of datum (including the datum itself) strictly closer than Eps to datum i.
+        size_t NeighbourCount(size_t i, SpatialType_ Eps) const {
+            const auto Comparable = DistanceMetric_t::ToComparable(Eps);
+            const auto Begin = this->Distances.begin() + this->Offsets[i];
+            const auto End = this->Distances.begin() + this->Offsets[i + 1];
+            return static_cast<size_t>(std::distance(Begin, std::lower_bound(Begin, End, Comparable)));
+        }
+
+        //Performs DBSCAN using only cached neighbourhoods. The result is identical to the const overload of
+        // DBSCAN() run against the same R*-tree with the same parameters.
+        //
+        // NOTE: DBSCAN() clusters 1D datum by sorting (see DBSCANSortAndSweepLabels()), which assigns border datum
+        //       reachable from two clusters to the lower-numbered cluster. The same rule is applied here for 1D
+        //       datum so the results still match.
+        std::vector<ClusterID_t> Labels(SpatialType_ Eps, size_t MinPts) const {
+            if(this->EpsMax < Eps) throw std::runtime_error("Requested Eps exceeds the cached maximum Eps.");
+
+            const size_t N = this->size();
+            std::vector<ClusterID_t> Out(N, ClusterID_t(ClusterID_t::Unclassified));
+
+            //The Eps-neighbourhood sizes are found up-front, since each is needed at least once.
+            std::vector<size_t> Count(N);
+            for(size_t i = 0; i < N; ++i) Count[i] = this->NeighbourCount(i, Eps);
+
+            //This mirrors the cluster expansion loop in DBSCANExpandClusters(). Clusters are expanded one at a
+            // time, so the order of datum within a neighbourhood does not influence the result.
+            //
+            // Clusters are numbered in the order they are expanded, so the lowest-numbered cluster reaching a border
+            // datum is the first one. In 1D, border datum are therefore never relabelled once classified.
+            constexpr bool KeepFirstCluster = (ClusteringDatum_t::SpatialDimensionCount_ == 1);
+            auto WorkingCID = ClusterID_t().NextValidClusterID();
+            std::vector<IndexType_> Seeds;
+            for(size_t i = 0; i < N; ++i){
+                if(!Out[i].IsUnclassified()) continue;
+                if(Count[i] < MinPts){
+                    Out[i].Raw = ClusterID_t::Noise;
+                    continue;
+                }
+
+                Seeds.clear();
+                for(size_t k = this->Offsets[i]; k < (this->Offsets[i] + Count[i]); ++k){
+                    const IndexType_ j = this->Neighbours[k];
+                    if(KeepFirstCluster && Out[j].IsRegular()) continue;
+                    Out[j] = WorkingCID;
+                    if(j != i) Seeds.push_back(j);
+                }
+
+                for(size_t SeedsHead = 0; SeedsHead < Seeds.size(); ++SeedsHead){
+                    const IndexType_ q = Seeds[SeedsHead];
+                    if(Count[q] < MinPts) continue;
+                    for(size_t k = this->Offsets[q]; k < (this->Offsets[q] + Count[q]); ++k){
+                        const IndexType_ j = this->Neighbours[k];
+                        if(Out[j].IsUnclassified() || Out[j].IsNoise()){
+                            if(Out[j].IsUnclassified()) Seeds.push_back(j);
+                            Out[j] = WorkingCID;
+                        }
+                    }
+                }
+                WorkingCID = WorkingCID.NextValidClusterID();
+            }
+            return Out;
+        }
+};
+
+
+//A single result from DBSCANSweep().
+template < typename ClusteringDatum_t >
+struct DBSCANSweepResult {
+    typename ClusteringDatum_t::SpatialType_ Eps;
+    size_t MinPts;
+    std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > Labels; //In R*-tree traversal order.
+};
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+std::vector< DBSCANSweepResult<ClusteringDatum_t> >
+    DBSCANSweep( const RTree_t & RTree,
+                 const std::vector<typename ClusteringDatum_t::SpatialType_> & EpsValues,
+                 const std::vector<size_t> & MinPtsValues,
+                 SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin,
+                 size_t ThreadCount = DefaultClusteringThreadCount() ){
+
+    // This routine performs DBSCAN for every combination of the provided Eps and MinPts values. The spatial
+    //   queries are performed only once, at the largest Eps, and every clustering is then derived from the cached
+    //   neighbourhoods. This is useful when searching for suitable parameters (e.g., when trying a variety of
+    //   dimension scaling factors, as suggested in DBSCAN()).
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will not be modified.
+    // 2. EpsValues --> The DBSCAN Eps parameters to try. See DBSCAN().
+    // 3. MinPtsValues --> The DBSCAN MinPts parameters to try. See DBSCAN().
+    // 4. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+    //                              UseGrid is not supported, since neighbourhoods need to be enumerated.
+    // 5. ThreadCount --> The number of threads used to build the neighbourhood cache.
+    //
+    // Results are returned for each Eps (outer) and MinPts (inner) in the order provided. Labels are stored in
+    //   R*-tree traversal order, like the const overload of DBSCAN().
+    //
+    // NOTE: See DBSCANNeighbourCache regarding memory usage. If many sweeps over the same data are needed, use
+    //       the cache directly.
+    //
+    std::vector< DBSCANSweepResult<ClusteringDatum_t> > out;
+    if(EpsValues.empty() || MinPtsValues.empty()) return out;
+
+    const auto EpsMax = *std::max_element(EpsValues.begin(), EpsValues.end());
+    const DBSCANNeighbourCache<RTree_t, ClusteringDatum_t, DistanceMetric_t> Cache(RTree, EpsMax,
+                                                                                   UsersSpatialQueryTechnique,
+                                                                                   ThreadCount);
+    for(const auto Eps : EpsValues){
+        for(const auto MinPts : MinPtsValues){
+            out.push_back( { Eps, MinPts, Cache.Labels(Eps, MinPts) } );
+        }
+    }
+    return out;
+}
+
+#endif //YGOR_CLUSTERING_DBSCANSWEEP_HPP
@@ -0,0 +1,452 @@
+
+#ifndef YGOR_CLUSTERING_DBSCANTILED_HPP
+#define YGOR_CLUSTERING_DBSCANTILED_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <array>
+#include <map>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <fstream>
+#include <filesystem>
+#include <random>
+#include <sstream>
+#include <type_traits>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringIndexed.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+
+
+//This class manages the scratch files used by DBSCANTiled(). Each tile has a handful of flat binary files holding
+// arrays of trivially copyable records. The files live in a private subdirectory of the given directory, which is
+// created exclusively (so concurrent runs, even in other processes, can never share files) and is removed along with
+// its contents when the object is destroyed.
+//
+// Files for distinct tiles may be accessed concurrently.
+class DBSCANTiledScratch {
+    private:
+        std::filesystem::path Directory;
+
+    public:
+        DBSCANTiledScratch(const std::string &Dir){
+            if(!std::filesystem::is_directory(Dir)){
+                throw std::runtime_error("Scratch directory '" + Dir + "' does not exist.");
+            }
+            //Directory creation either succeeds or finds an existing entry atomically, so a randomly-named
+            // subdirectory that we manage to create is ours alone. Collisions are astronomically unlikely, but
+            // are retried anyway.
+            std::random_device rd;
+            std::uniform_int_distribution<uint64_t> ud;
+            constexpr int MaxAttempts = 16;
+            for(int i = 0; i < MaxAttempts; ++i){
+                std::ostringstream name;
+                name << "ygorclustering_tiled_" << std::hex << ud(rd) << ud(rd);
+                const auto p = std::filesystem::path(Dir) / name.str();
+                std::error_code ec;
+                if(std::filesystem::create_directory(p, ec)){
+                    this->Directory = p;
+                    return;
+                }
+                if(ec){
+                    throw std::runtime_error("Unable to create scratch directory '" + p.string() + "': " + ec.message());
+                }
+            }
+            throw std::runtime_error("Unable to create a unique scratch directory in '" + Dir + "'.");
+        }
+
+        DBSCANTiledScratch(const DBSCANTiledScratch &) = delete;
+        DBSCANTiledScratch & operator=(const DBSCANTiledScratch &) = delete;
+
+        ~DBSCANTiledScratch(){
+            std::error_code ec;
+            std::filesystem::remove_all(this->Directory, ec);
+        }
+
+        std::filesystem::path Path(size_t Tile, const std::string &Kind){
+            return this->Directory / (std::to_string(Tile) + "_" + Kind + ".bin");
+        }
+
+        template <typename Record_t>
+        void Append(size_t Tile, const std::string &Kind, const std::vector<Record_t> &Records){
+            static_assert(std::is_trivially_copyable<Record_t>::value, "Records must be trivially copyable.");
+            if(Records.empty()) return;
+            const auto p = this->Path(Tile, Kind);
+            std::ofstream FO(p, std::ios::binary | std::ios::app);
+            FO.write(reinterpret_cast<const char *>(Records.data()),
+                     static_cast<std::streamsize>(Records.size() * sizeof(Record_t)));
+            if(!FO) throw std::runtime_error("Unable to write scratch file '" + p.string() + "'.");
+            return;
+        }
+
+        template <typename Record_t>
+        void Write(size_t Tile, const std::string &Kind, const std::vector<Record_t> &Records){
+            static_assert(std::is_trivially_copyable<Record_t>::value, "Records must be trivially copyable.");
+            const auto p = this->Path(Tile, Kind);
+            std::ofstream FO(p, std::ios::binary | std::ios::trunc);
+            FO.write(reinterpret_cast<const char *>(Records.data()),
+                     static_cast<std::streamsize>(Records.size() * sizeof(Record_t)));
+            if(!FO) throw std::runtime_error("Unable to write scratch file '" + p.string() + "'.");
+            return;
+        }
+
+        template <typename Record_t>
+        std::vector<Record_t> Read(size_t Tile, const std::string &Kind){
+            std::vector<Record_t> out;
+            const auto p = this->Path(Tile, Kind);
+            if(!std::filesystem::exists(p)) return out;
+            const auto Bytes = std::filesystem::file_size(p);
+            if((Bytes % sizeof(Record_t)) != 0) throw std::runtime_error("Scratch file '" + p.string() + "' is corrupt.");
+            out.resize(Bytes / sizeof(Record_t));
+            std::ifstream FI(p, std::ios::binary);
+            FI.read(reinterpret_cast<char *>(out.data()), static_cast<std::streamsize>(Bytes));
+            if(!FI) throw std::runtime_error("Unable to read scratch file '" + p.string() + "'.");
+            return out;
+        }
+};
+
+
+template < typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename RTreeParameter_t = boost::geometry::index::rstar<16>,
+           typename DatumSource_t,
+           typename LabelSink_t >
+void DBSCANTiled( DatumSource_t Source,
+                  LabelSink_t Sink,
+                  typename ClusteringDatum_t::SpatialType_ Eps,
+                  size_t MinPts,
+                  typename ClusteringDatum_t::SpatialType_ TileSize,
+                  const std::string & ScratchDirectory,
+                  size_t ThreadCount = DefaultClusteringThreadCount() ){
+
+    // This routine performs DBSCAN on datasets too large to hold in memory at once. Space is divided into a regular
+    //   grid of hyper-cubic tiles. Each tile is clustered independently, along with a 'halo' of neighbouring datum
+    //   within Eps of its border, and the per-tile clusters are then stitched together.
+    //
+    // The procedure is as follows:
+    //   1. Datum are streamed from the source once and spilled to per-tile scratch files. Each datum is 'owned' by
+    //      the tile containing it, and a copy is placed in the halo of every other tile within Eps.
+    //   2. Tiles are loaded one at a time (one per thread) to decide which of their owned datum are core datum.
+    //      A tile plus its halo holds the entire Eps-neighbourhood of every owned datum, so this is exact.
+    //   3. Tiles are loaded again and their core datum (owned, or in the halo) are grouped into local clusters.
+    //      Owned non-core datum join the local cluster of a neighbouring core datum, or are noise.
+    //   4. Local clusters are merged with a disjoint-set forest, linking each halo core datum's local cluster to
+    //      the cluster it belongs to in the tile that owns it. Only the per-cluster forest is held in memory.
+    //   5. Final labels are streamed to the sink, tile by tile.
+    //
+    // The result is equivalent to DBSCAN() on the whole dataset: the same datum are noise and core datum are grouped
+    //   into the same clusters. Border datum reachable from two or more clusters may be assigned differently.
+    //
+    // User parameters:
+    //
+    // 1. Source --> A functor of the sort std::function<bool(ClusteringDatum_t &)>. Each call should overwrite the
+    //               provided datum with the next datum and return true, or return false when there are no more.
+    //               Only spatial coordinates are used.
+    // 2. Sink --> A functor of the sort std::function<void(uint64_t, ClusterID<...>)>. It is called exactly once
+    //             for each datum with the datum's position in the source sequence and its ClusterID. Calls are made
+    //             from the calling thread, grouped by tile rather than in source order.
+    // 3. Eps --> DBSCAN algorithm parameter. See DBSCAN().
+    // 4. MinPts --> DBSCAN algorithm parameter. See DBSCAN().
+    // 5. TileSize --> The edge length of the tiles. Peak memory is proportional to the number of datum in a tile
+    //                 plus its halo (times ThreadCount), so it should be chosen with the data density in mind.
+    //                 Tiles much smaller than Eps duplicate datum into many halos and should be avoided.
+    // 6. ScratchDirectory --> An existing directory with room for roughly twice the size of the coordinates. Scratch
+    //                         files are written to a uniquely-named subdirectory, so several runs can share it.
+    //                         The subdirectory is removed before returning.
+    // 7. ThreadCount --> The number of tiles processed concurrently.
+    //
+    // NOTE: Clusters are numbered in the order they are first encountered while emitting labels.
+    //
+    typedef typename ClusteringDatum_t::SpatialType_ T;
+    static_assert(std::is_floating_point<T>::value,
+                  "DBSCANTiled requires floating-point coordinates. See ClusteringDistanceType.");
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+    constexpr size_t D = ClusteringDatum_t::SpatialDimensionCount_;
+    typedef IndexedClusteringPoint<D, T> Point_t;
+    typedef boost::geometry::index::rtree<Point_t, RTreeParameter_t> RTree_t;
+    typedef std::array<int64_t, D> TileKey_t;
+
+    struct OwnedRecord {
+        std::array<T, D> Coordinates;
+        uint64_t Index;          //Position in the source sequence.
+    };
+    struct HaloRecord {
+        std::array<T, D> Coordinates;
+        uint64_t OwnerPosition;  //Position within the owning tile's owned records.
+        uint32_t OwnerTile;
+    };
+    struct LinkRecord {
+        uint64_t OwnerPosition;
+        uint32_t OwnerTile;
+        uint32_t LocalCluster;
+    };
+    constexpr uint32_t NoCluster = std::numeric_limits<uint32_t>::max();
+
+    if(!(static_cast<T>(0) < Eps)) throw std::runtime_error("Parameter 'Eps' must be positive.");
+    if(!(static_cast<T>(0) < TileSize)) throw std::runtime_error("Parameter 'TileSize' must be positive.");
+    if(MinPts == 0) throw std::runtime_error("Parameter 'MinPts' must be >= 1.");
+
+    DBSCANTiledScratch Scratch(ScratchDirectory);
+
+    //Step 1: partition.
+    std::map<TileKey_t, uint32_t> TileIds;
+    std::vector<uint64_t> OwnedCount;
+    std::vector<std::vector<OwnedRecord>> OwnedBuffer;
+    std::vector<std::vector<HaloRecord>> HaloBuffer;
+    size_t Buffered = 0;
+    const size_t BufferLimit = static_cast<size_t>(64) << 20; //Bytes.
+
+    auto TileOf = [&](const TileKey_t &Key) -> uint32_t {
+        const auto it = TileIds.find(Key);
+        if(it != TileIds.end()) return it->second;
+        if(static_cast<size_t>(std::numeric_limits<uint32_t>::max() - 1) < TileIds.size()){
+            throw std::runtime_error("Too many tiles. Increase the tile size.");
+        }
+        const auto Id = static_cast<uint32_t>(TileIds.size());
+        TileIds.emplace(Key, Id);
+        OwnedCount.push_back(0);
+        OwnedBuffer.emplace_back();
+        HaloBuffer.emplace_back();
+        return Id;
+    };
+    auto FlushBuffers = [&](void) -> void {
+        for(size_t t = 0; t < OwnedBuffer.size(); ++t){
+            Scratch.Append(t, "owned", OwnedBuffer[t]);
+            Scratch.Append(t, "halo", HaloBuffer[t]);
+            OwnedBuffer[t].clear();
+            OwnedBuffer[t].shrink_to_fit();
+            HaloBuffer[t].clear();
+            HaloBuffer[t].shrink_to_fit();
+        }
+        Buffered = 0;
+        return;
+    };
+
+    {
+        ClusteringDatum_t Datum;
+        uint64_t Index = 0;
+        TileKey_t Key, Lo, Hi, Halo;
+        while(Source(Datum)){
+            for(size_t d = 0; d < D; ++d){
+                const T x = Datum.Coordinates[d];
+                //The halo range is widened slightly so round-off can only ever add datum to a halo.
+                const T Slack = (std::abs(x) + Eps) * static_cast<T>(4) * std::numeric_limits<T>::epsilon();
+                Key[d] = static_cast<int64_t>(std::floor(x / TileSize));
+                Lo[d] = static_cast<int64_t>(std::floor((x - Eps - Slack) / TileSize));
+                Hi[d] = static_cast<int64_t>(std::floor((x + Eps + Slack) / TileSize));
+            }
+            const uint32_t Owner = TileOf(Key);
+            const uint64_t Position = OwnedCount[Owner]++;
+            OwnedBuffer[Owner].push_back( OwnedRecord{ Datum.Coordinates, Index } );
+            Buffered += sizeof(OwnedRecord);
+
+            //Visit every tile in [Lo, Hi] except the owner.
+            Halo = Lo;
+            for(;;){
+                if(Halo != Key){
+                    const uint32_t t = TileOf(Halo);
+                    HaloBuffer[t].push_back( HaloRecord{ Datum.Coordinates, Position, Owner } );
+                    Buffered += sizeof(HaloRecord);
+                }
+                size_t d = 0;
+                while((d < D) && (Halo[d] == Hi[d])){
+                    Halo[d] = Lo[d];
+                    ++d;
+                }
+                if(d == D) break;
+                ++Halo[d];
+            }
+
+            ++Index;
+            if(BufferLimit < Buffered) FlushBuffers();
+        }
+        FlushBuffers();
+    }
+    const size_t TileCount = TileIds.size();
+
+    const std::string ThrowTileTooLarge = "Too many datum in a single tile. Decrease the tile size.";
+
+    //Loads a tile and its halo into an R*-tree. Owned datum are numbered first, then halo datum, so together they
+    // must fit in the 32-bit point indices.
+    auto LoadTile = [&](size_t t, std::vector<HaloRecord> &Halo) -> RTree_t {
+        const auto Owned = Scratch.Read<OwnedRecord>(t, "owned");
+        Halo = Scratch.Read<HaloRecord>(t, "halo");
+        if(static_cast<uint64_t>(std::numeric_limits<uint32_t>::max())
+           < (static_cast<uint64_t>(Owned.size()) + static_cast<uint64_t>(Halo.size()))){
+            throw std::runtime_error(ThrowTileTooLarge);
+        }
+        std::vector<Point_t> Points;
+        Points.reserve(Owned.size() + Halo.size());
+        for(const auto &r : Owned) Points.emplace_back( r.Coordinates, static_cast<uint32_t>(Points.size()) );
+        for(const auto &r : Halo) Points.emplace_back( r.Coordinates, static_cast<uint32_t>(Points.size()) );
+        return RTree_t(Points.begin(), Points.end());
+    };
+    for(size_t t = 0; t < TileCount; ++t){
+        if(static_cast<uint64_t>(std::numeric_limits<uint32_t>::max() / 2) < OwnedCount[t]){
+            throw std::runtime_error(ThrowTileTooLarge);
+        }
+    }
+
+    //Step 2: core datum.
+    ParallelForEachIndex(TileCount, ThreadCount, [&](size_t t) -> void {
+        if(OwnedCount[t] == 0) return;
+        std::vector<HaloRecord> Halo;
+        const RTree_t RTree = LoadTile(t, Halo);
+        std::vector<uint8_t> Core(OwnedCount[t], 0);
+
+        //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
+        constexpr auto RTreeQueryGetAll = [](const Point_t &) -> bool { return true; };
+        typename RTree_t::const_query_iterator it;
+        it = RTree.qbegin(boost::geometry::index::satisfies( RTreeQueryGetAll ));
+        for( ; it != RTree.qend(); ++it){
+            if(OwnedCount[t] <= it->Index) continue;
+            size_t Count = 0;
+            OnEachDatumWithinEps<RTree_t, Point_t, DistanceMetric_t>(RTree, *it, Eps, SpatialQueryTechnique::UseWithin,
+                [&Count](const Point_t &) -> void { ++Count; });
+            Core[it->Index] = (MinPts <= Count) ? 1 : 0;
+        }
+        Scratch.Write(t, "core", Core);
+    }, 1);
+
+    //Step 3: local clusters.
+    std::vector<uint32_t> LocalClusterCount(TileCount, 0);
+    ParallelForEachIndex(TileCount, ThreadCount, [&](size_t t) -> void {
+        if(OwnedCount[t] == 0) return;
+        std::vector<HaloRecord> Halo;
+        const RTree_t RTree = LoadTile(t, Halo);
+        const RTreeDatumIndex<RTree_t, Point_t> Index(RTree);
+        const size_t NOwned = OwnedCount[t];
+        const size_t N = Index.size();
+
+        //Core flags are authoritative only in the owning tile.
+        std::vector<uint8_t> Core = Scratch.Read<uint8_t>(t, "core");
+        Core.resize(N, 0);
+        {
+            std::map<uint32_t, std::vector<uint8_t>> OwnerCore;
+            for(size_t h = 0; h < Halo.size(); ++h){
+                auto it = OwnerCore.find(Halo[h].OwnerTile);
+                if(it == OwnerCore.end()){
+                    it = OwnerCore.emplace(Halo[h].OwnerTile, Scratch.Read<uint8_t>(Halo[h].OwnerTile, "core")).first;
+                }
+                Core[NOwned + h] = it->second.at(Halo[h].OwnerPosition);
+            }
+        }
+        std::vector<const Point_t *> ByPosition(N, nullptr);
+        for(const auto *p : Index.Datum) ByPosition[p->Index] = p;
+
+        std::vector<uint32_t> Local(N, NoCluster);
+        uint32_t Clusters = 0;
+        std::vector<const Point_t *> Queue, Neighbours;
+        for(size_t i = 0; i < N; ++i){
+            if(!Core[i] || (Local[i] != NoCluster)) continue;
+            const uint32_t c = Clusters++;
+            Local[i] = c;
+            Queue.assign(1, ByPosition[i]);
+            for(size_t Head = 0; Head < Queue.size(); ++Head){
+                Neighbours.clear();
+                GatherDatumWithinEps<RTree_t, Point_t, DistanceMetric_t>(RTree, *(Queue[Head]), Eps,
+                                                                          SpatialQueryTechnique::UseWithin, Neighbours);
+                for(const auto *r : Neighbours){
+                    const size_t j = r->Index;
+                    if(Local[j] != NoCluster) continue;
+                    if(Core[j]){
+                        Local[j] = c;
+                        Queue.push_back(r);
+                    }else if(j < NOwned){
+                        Local[j] = c;
+                    }
+                }
+            }
+        }
+
+        std::vector<LinkRecord> Links;
+        for(size_t h = 0; h < Halo.size(); ++h){
+            if(Core[NOwned + h]) Links.push_back( LinkRecord{ Halo[h].OwnerPosition, Halo[h].OwnerTile, Local[NOwned + h] } );
+        }
+        Local.resize(NOwned);
+        Scratch.Write(t, "labels", Local);
+        Scratch.Write(t, "links", Links);
+        LocalClusterCount[t] = Clusters;
+    }, 1);
+
+    //Step 4: merge local clusters across tile borders.
+    std::vector<size_t> Offset(TileCount + 1, 0);
+    for(size_t t = 0; t < TileCount; ++t) Offset[t + 1] = Offset[t] + LocalClusterCount[t];
+    std::vector<size_t> Parent(Offset[TileCount]);
+    for(size_t i = 0; i < Parent.size(); ++i) Parent[i] = i;
+    auto Find = [&](size_t i) -> size_t {
+        while(Parent[i] != i) i = Parent[i] = Parent[Parent[i]];
+        return i;
+    };
+    for(size_t t = 0; t < TileCount; ++t){
+        const auto Links = Scratch.Read<LinkRecord>(t, "links");
+        std::map<uint32_t, std::vector<uint32_t>> OwnerLabels;
+        for(const auto &l : Links){
+            auto it = OwnerLabels.find(l.OwnerTile);
+            if(it == OwnerLabels.end()){
+                it = OwnerLabels.emplace(l.OwnerTile, Scratch.Read<uint32_t>(l.OwnerTile, "labels")).first;
+            }
+            const uint32_t Theirs = it->second.at(l.OwnerPosition);
+            if(Theirs == NoCluster) throw std::runtime_error("Halo core datum is unlabeled in its own tile.");
+            const size_t a = Find(Offset[t] + l.LocalCluster);
+            const size_t b = Find(Offset[l.OwnerTile] + Theirs);
+            if(a != b) Parent[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+    //Step 5: emit labels.
+    std::vector<ClusterID_t> Final(Parent.size(), ClusterID_t(ClusterID_t::Unclassified));
+    auto WorkingCID = ClusterID_t().NextValidClusterID();
+    bool Used = false;
+    for(size_t t = 0; t < TileCount; ++t){
+        if(OwnedCount[t] == 0) continue;
+        const auto Owned = Scratch.Read<OwnedRecord>(t, "owned");
+        const auto Local = Scratch.Read<uint32_t>(t, "labels");
+        for(size_t i = 0; i < Owned.size(); ++i){
+            if(Local[i] == NoCluster){
+                Sink(Owned[i].Index, ClusterID_t(ClusterID_t::Noise));
+                continue;
+            }
+            auto &CID = Final[ Find(Offset[t] + Local[i]) ];
+            if(CID.IsUnclassified()){
+                if(Used) WorkingCID = WorkingCID.NextValidClusterID();
+                CID = WorkingCID;
+                Used = true;
+            }
+            Sink(Owned[i].Index, CID);
+        }
+    }
+    return;
+}
+
+#endif //YGOR_CLUSTERING_DBSCANTILED_HPP
@@ -35,6 +35,7 @@
 #include <set>
 #include <random>
 #include <sstream>
+#include <type_traits>
 
 #include <boost/geometry.hpp>
 #include <boost/geometry/geometries/point.hpp>
@@ -50,6 +51,35 @@
 class ClusteringUserDataEmptyClass { }; //Used to optionally forgo passing in extra data.
 
 
+//Empty members (e.g., ClusteringUserDataEmptyClass) normally occupy at least one byte, which is often padded out to
+// several. This attribute lets them share storage with other members, so they take no space at all. It is standard
+// in C++20, and supported as an extension by some C++17 compilers.
+#if defined(__has_cpp_attribute)
+    #if __has_cpp_attribute(no_unique_address)
+        #define YGORCLUSTERING_NO_UNIQUE_ADDRESS [[no_unique_address]]
+        #define YGORCLUSTERING_HAS_NO_UNIQUE_ADDRESS
+    #elif __has_cpp_attribute(msvc::no_unique_address)
+        #define YGORCLUSTERING_NO_UNIQUE_ADDRESS [[msvc::no_unique_address]]
+        #define YGORCLUSTERING_HAS_NO_UNIQUE_ADDRESS
+    #endif
+#endif
+#if !defined(YGORCLUSTERING_NO_UNIQUE_ADDRESS)
+    #define YGORCLUSTERING_NO_UNIQUE_ADDRESS
+#endif
+
+
+//The type used for distances (and comparable distances, e.g., squared distances) between datum with the given
+// coordinate type. Floating-point coordinates use their own type, so float coordinates are compared in float.
+// Integer (e.g., fixed-point) coordinates use double, so squared differences cannot overflow and Eps need not be a
+// whole number of quanta. Differences below 2^26 quanta are squared exactly.
+template < typename SpatialType >
+struct ClusteringDistanceType {
+    static_assert(std::is_arithmetic<SpatialType>::value, "Spatial coordinates must be arithmetic.");
+    typedef typename std::conditional< std::is_floating_point<SpatialType>::value,
+                                       SpatialType, double >::type type;
+};
+
+
 //An example class which is destined for a clustering algorithm. This class is heavily templated so it can
 // be easily extended by the user.
 //
@@ -61,6 +91,11 @@ class ClusteringUserDataEmptyClass { }; //Used to optionally forgo passing in ex
 // by including an extra header file. If you're wondering whether a certain type will work, the best way to
 // find out is simply to try compiling with it. If it doesn't work, Boost.Geometry will let you know by 
 // claiming many templated functions/structs are missing.
+//
+// Copies and moves are member-wise and compiler-generated. When the UserDataClass is trivially copyable (e.g., the
+// default empty class or an integer index), so is the datum, and the R*-tree's many internal copies (e.g., while
+// splitting nodes) reduce to plain memory copies. Empty user data takes no space where the compiler supports
+// YGORCLUSTERING_NO_UNIQUE_ADDRESS.
 // 
 template < std::size_t SpatialDimensionCount,   //For 3D data, this would be 3.
            typename SpatialType,                //Generally a double.
@@ -73,6 +108,7 @@ class ClusteringDatum {
         //Type-defs and constants. (For accessibility after instantiation.)
         constexpr static size_t SpatialDimensionCount_ = SpatialDimensionCount;
         typedef SpatialType SpatialType_;
+        typedef typename ClusteringDistanceType<SpatialType>::type DistanceType_;
         constexpr static size_t AttributeDimensionCount_ = AttributeDimensionCount;
         typedef AttributeType AttributeType_;
         typedef ClusterIDType ClusterIDType_;
@@ -81,51 +117,24 @@ class ClusteringDatum {
         std::array<SpatialType, SpatialDimensionCount> Coordinates; //For spatial indexing in the R*-tree.
         std::array<AttributeType, AttributeDimensionCount> Attributes; //May be indexed in the R*-tree. Depends on algorithm.
         ClusterID<ClusterIDType> CID;
+        YGORCLUSTERING_NO_UNIQUE_ADDRESS
         UserDataClass UserData;
 
-        //Constructors.
-        ClusteringDatum() {
-            this->Coordinates.fill( SpatialType() );
-            this->Attributes.fill( AttributeType() );
-            this->CID = ClusterID<ClusterIDType>();
-            this->UserData = UserDataClass();
-        };
-        ClusteringDatum(const ClusteringDatum &in){
-            // The following superfluous assignments are used to silence spurious 'maybe-uninitialized' warnings.
-            this->Coordinates.fill( SpatialType() );
-            this->Attributes.fill( AttributeType() );
-            this->CID = ClusterID<ClusterIDType>();
-            this->UserData = UserDataClass();
-
-            // Actual assignment happens here.
-            *this = in;
-        };
-        constexpr ClusteringDatum(const decltype(Coordinates) &in) : Coordinates(in) {
-            this->Attributes.fill( AttributeType() );
-            this->CID = ClusterID<ClusterIDType>();
-            this->UserData = UserDataClass();
-        };
+        //Constructors. Arrays are value-initialized (i.e., zeroed).
+        constexpr ClusteringDatum() : Coordinates(), Attributes(), CID(), UserData() { };
+        constexpr ClusteringDatum(const decltype(Coordinates) &in) : Coordinates(in), Attributes(), CID(), UserData() { };
         constexpr ClusteringDatum(const decltype(Coordinates) &a, 
-                                  const decltype(Attributes) &b) : Coordinates(a), Attributes(b) {
-            this->CID = ClusterID<ClusterIDType>();
-            this->UserData = UserDataClass();
-        };
+                                  const decltype(Attributes) &b) : Coordinates(a), Attributes(b), CID(), UserData() { };
         ClusteringDatum(const decltype(Coordinates) &a,
                         const decltype(Attributes) &b,
-                        const decltype(UserData) &c) : Coordinates(a), Attributes(b), UserData(c) {
-            this->CID = ClusterID<ClusterIDType>();
-        };
+                        const decltype(UserData) &c) : Coordinates(a), Attributes(b), CID(), UserData(c) { };
 
-        //Member functions.
-        ClusteringDatum & operator=(const ClusteringDatum &rhs){
-           if(this == &rhs) return *this;
-           this->Coordinates   = rhs.Coordinates;
-           this->Attributes    = rhs.Attributes;
-           this->CID           = rhs.CID;
-           this->UserData      = rhs.UserData;           
-           return *this;
-        }
+        ClusteringDatum(const ClusteringDatum &) = default;
+        ClusteringDatum(ClusteringDatum &&) = default;
+        ClusteringDatum & operator=(const ClusteringDatum &) = default;
+        ClusteringDatum & operator=(ClusteringDatum &&) = default;
 
+        //Member functions.
         bool operator==(const ClusteringDatum &in) const {
             //Default only considers spatial information so it can be used in spatial indexes.
             return (this->Coordinates == in.Coordinates);
@@ -161,6 +170,16 @@ class ClusteringDatum {
 
 };
 
+//The datum should be trivially copyable whenever its user data is, and empty user data should take no space.
+static_assert(std::is_trivially_copyable< ClusteringDatum<3, double, 0, double> >::value,
+              "ClusteringDatum should be trivially copyable when its user data is.");
+static_assert(std::is_trivially_copyable< ClusteringDatum<2, float, 1, float, uint16_t, uint32_t> >::value,
+              "ClusteringDatum should be trivially copyable when its user data is.");
+#if defined(YGORCLUSTERING_HAS_NO_UNIQUE_ADDRESS)
+static_assert(sizeof(ClusteringDatum<2, float, 1, float, uint32_t>) == 4 * sizeof(float),
+              "Empty user data should take no space.");
+#endif
+
 
 
 //This code 'registers' the ClusteringDatum class so it can be used as a Boost Geometry "point" type.
@@ -0,0 +1,36 @@
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+//This file compiles the explicit instantiations declared in YgorClusteringDatumCommonInstantiations.hpp into the
+// ygorclustering_common library.
+
+//The bounded nearest-neighbour query in DBSCANSortedkDistGraph() makes GCC warn (-Warray-bounds) that Boost's
+// R*-tree distance query sorts past the end of its fixed-capacity branch list. The list never holds more than a node's
+// children, so the warning is spurious. The sort is inlined into Boost's query visitor, and GCC matches the pragma
+// against that location, so it has to be in effect where the R*-tree headers are included.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+#define YGORCLUSTERING_DEFINE_COMMON_INSTANTIATIONS
+#include "YgorClusteringDatumCommonInstantiations.hpp"
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,114 @@
+
+#ifndef YGOR_CLUSTERING_FIXEDPOINT_HPP
+#define YGOR_CLUSTERING_FIXEDPOINT_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <array>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+
+
+//This class converts between real-valued coordinates and fixed-point integer coordinates, which can be stored in a
+// ClusteringDatum instead of floating-point coordinates. Each integer step (i.e., quantum) represents Scale units
+// along every axis, and integer zero corresponds to Origin:
+//
+//     x_real = Origin[d] + Scale * x_integer.
+//
+// A single Scale is shared by all axes, so distances are preserved (up to rounding) and metrics remain meaningful.
+//
+// For example, sensor data spanning a few kilometres with millimetre resolution fits comfortably in int32_t:
+//
+//     typedef ClusteringDatum<3, int32_t, 0, float, uint32_t> CDat_t;
+//     const FixedPointCoordinateCodec<3, int32_t> Codec({ 1000.0, 2000.0, 0.0 }, 0.001);
+//     CDat_t P( Codec.Encode({ x, y, z }) );
+//     ...
+//     DBSCAN<RTree_t, CDat_t>(rtree, Codec.EncodeDistance(Eps), MinPts);
+//
+// Encoded distances are real-valued (see ClusteringDistanceType), so Eps need not be a whole number of quanta and
+// clustering decisions match those for the decoded coordinates, apart from the rounding of coordinates to the
+// nearest quantum.
+//
+// NOTE: Only signed integer types are supported. Encode() only accepts coordinates within half of the integer
+//       range, so bounding boxes built around datum (which extend by Eps) cannot overflow as long as Eps is also
+//       smaller than half of the range.
+//
+template < std::size_t SpatialDimensionCount,
+           typename IntegerType = int32_t >
+class FixedPointCoordinateCodec {
+    public:
+        static_assert(std::is_integral<IntegerType>::value && std::is_signed<IntegerType>::value,
+                      "Fixed-point coordinates must be a signed integer type.");
+
+        typedef std::array<double, SpatialDimensionCount> RealCoordinates_t;
+        typedef std::array<IntegerType, SpatialDimensionCount> FixedCoordinates_t;
+
+        RealCoordinates_t Origin;
+        double Scale; //Real units per quantum.
+
+        FixedPointCoordinateCodec(const RealCoordinates_t &O, double S) : Origin(O), Scale(S) {
+            if(!std::isfinite(this->Scale) || !(0.0 < this->Scale)){
+                throw std::runtime_error("Fixed-point scale must be positive and finite.");
+            }
+            for(const auto &o : this->Origin){
+                if(!std::isfinite(o)) throw std::runtime_error("Fixed-point origin must be finite.");
+            }
+        }
+
+        //The largest magnitude Encode() will produce.
+        static constexpr IntegerType Limit(void){
+            return std::numeric_limits<IntegerType>::max() / 2;
+        }
+
+        FixedCoordinates_t Encode(const RealCoordinates_t &x) const {
+            FixedCoordinates_t out;
+            for(size_t d = 0; d < SpatialDimensionCount; ++d){
+                const double q = std::round((x[d] - this->Origin[d]) / this->Scale);
+                if(!(std::abs(q) <= static_cast<double>(Limit()))){
+                    throw std::runtime_error("Coordinate cannot be represented with this fixed-point origin and scale.");
+                }
+                out[d] = static_cast<IntegerType>(q);
+            }
+            return out;
+        }
+
+        RealCoordinates_t Decode(const FixedCoordinates_t &q) const {
+            RealCoordinates_t out;
+            for(size_t d = 0; d < SpatialDimensionCount; ++d){
+                out[d] = this->Origin[d] + this->Scale * static_cast<double>(q[d]);
+            }
+            return out;
+        }
+
+        //Converts a real distance (e.g., Eps) to quanta, and back (e.g., for k-distances).
+        double EncodeDistance(double Distance) const {
+            return Distance / this->Scale;
+        }
+        double DecodeDistance(double Distance) const {
+            return Distance * this->Scale;
+        }
+};
+
+#endif //YGOR_CLUSTERING_FIXEDPOINT_HPP
@@ -0,0 +1,655 @@
+
+#ifndef YGOR_CLUSTERING_HDBSCAN_HPP
+#define YGOR_CLUSTERING_HDBSCAN_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <type_traits>
+#include <array>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <numeric>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringParallel.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+
+
+//The output of HDBSCANBuildHierarchy(). Datum are identified by their position in R*-tree traversal order (see
+// RTreeDatumIndex).
+template < typename ClusteringDatum_t >
+struct HDBSCANHierarchy {
+    typedef typename ClusteringDatum_t::SpatialType_ SpatialType_;
+    static_assert(std::is_floating_point<SpatialType_>::value,
+                  "HDBSCAN requires floating-point coordinates. See ClusteringDistanceType.");
+
+    //An edge of the minimum spanning tree of the mutual reachability graph.
+    struct Edge {
+        size_t A; //The smaller traversal index.
+        size_t B;
+        SpatialType_ Distance; //The mutual reachability distance.
+    };
+
+    //An entry of the condensed cluster tree. Children smaller than the number of datum are datum (which 'fall out'
+    // of the parent cluster at Lambda); all others are clusters (which split off from the parent at Lambda). Clusters
+    // are labeled from the number of datum upward, and the root cluster holding every datum is labeled first.
+    struct CondensedEntry {
+        size_t Parent;
+        size_t Child;
+        double Lambda;    //1/distance at which the child left the parent.
+        size_t ChildSize; //The number of datum in the child.
+    };
+
+    size_t MinPts;
+    size_t MinClusterSize;
+
+    std::vector<SpatialType_> CoreDistance;     //Indexed by traversal index.
+    std::vector<Edge> MinimumSpanningTree;      //In ascending order of distance.
+    std::vector<CondensedEntry> CondensedTree;  //Parents always precede their children.
+    std::vector<double> ClusterStability;       //Indexed by (cluster label - number of datum).
+};
+
+
+//This class is a kd-tree over a fixed set of datum that supports finding, for a given datum, the nearest datum in a
+// different connected component under the mutual reachability distance. It is an implementation detail of
+// HDBSCANBuildHierarchy().
+//
+// Every node records the component its datum all belong to (if they do), so whole subtrees within the query datum's
+// own component are skipped. This is what keeps the later Boruvka rounds cheap, when components are large; the
+// R*-tree cannot be annotated this way. Nodes also record the smallest core distance they hold, which bounds the
+// mutual reachability distance from below.
+//
+// All distances are comparable distances (see YgorClusteringMetrics.hpp).
+//
+template < typename ClusteringDatum_t,
+           typename DistanceMetric_t >
+class HDBSCANComponentTree {
+    public:
+        typedef typename ClusteringDatum_t::SpatialType_ T;
+        static constexpr size_t D = ClusteringDatum_t::SpatialDimensionCount_;
+        static constexpr size_t LeafSize = 16;
+        static constexpr size_t Mixed = std::numeric_limits<size_t>::max();
+
+    private:
+        struct Node {
+            size_t Begin;
+            size_t End;
+            size_t Left;  //Zero for leaves; the root is never a child.
+            size_t Right;
+            std::array<T, D> Min;
+            std::array<T, D> Max;
+            T MinCore;
+            size_t Component;
+        };
+
+        std::vector<Node> Nodes; //Children always follow their parents.
+        std::vector<std::array<T, D>> Coordinates; //In tree order.
+        std::vector<T> Core;                       //In tree order.
+        std::vector<size_t> Ids;                   //Tree order to traversal index.
+        std::vector<size_t> Components;            //In tree order.
+
+        T BoxLowerBound(const std::array<T, D> &X, const Node &n) const {
+            T A = static_cast<T>(0);
+            for(size_t d = 0; d < D; ++d){
+                const T below = n.Min[d] - X[d];
+                const T above = X[d] - n.Max[d];
+                const T delta = std::max<T>(static_cast<T>(0), std::max<T>(below, above));
+                A = DistanceMetric_t::Accumulate(A, delta);
+            }
+            return std::max<T>(A, n.MinCore);
+        }
+
+    public:
+        HDBSCANComponentTree(const std::vector<const ClusteringDatum_t *> &Datum,
+                             const std::vector<T> &ComparableCore){
+            const size_t N = Datum.size();
+            this->Ids.resize(N);
+            std::iota(this->Ids.begin(), this->Ids.end(), static_cast<size_t>(0));
+            if(N == 0) return;
+
+            this->Nodes.push_back( Node{ 0, N, 0, 0, {}, {}, static_cast<T>(0), Mixed } );
+            for(size_t n = 0; n < this->Nodes.size(); ++n){
+                const size_t Begin = this->Nodes[n].Begin;
+                const size_t End = this->Nodes[n].End;
+
+                std::array<T, D> Min, Max;
+                T MinCore = ComparableCore[this->Ids[Begin]];
+                for(size_t d = 0; d < D; ++d) Min[d] = Max[d] = Datum[this->Ids[Begin]]->Coordinates[d];
+                for(size_t k = Begin; k < End; ++k){
+                    const auto &P = *(Datum[this->Ids[k]]);
+                    for(size_t d = 0; d < D; ++d){
+                        Min[d] = std::min<T>(Min[d], P.Coordinates[d]);
+                        Max[d] = std::max<T>(Max[d], P.Coordinates[d]);
+                    }
+                    MinCore = std::min<T>(MinCore, ComparableCore[this->Ids[k]]);
+                }
+                this->Nodes[n].Min = Min;
+                this->Nodes[n].Max = Max;
+                this->Nodes[n].MinCore = MinCore;
+                if((End - Begin) <= LeafSize) continue;
+
+                //Split the widest dimension at the median.
+                size_t Widest = 0;
+                for(size_t d = 1; d < D; ++d){
+                    if((Max[Widest] - Min[Widest]) < (Max[d] - Min[d])) Widest = d;
+                }
+                const size_t Middle = Begin + (End - Begin) / 2;
+                std::nth_element(this->Ids.begin() + Begin, this->Ids.begin() + Middle, this->Ids.begin() + End,
+                                 [&](size_t L, size_t R) -> bool {
+                                     return Datum[L]->Coordinates[Widest] < Datum[R]->Coordinates[Widest];
+                                 });
+                this->Nodes[n].Left = this->Nodes.size();
+                this->Nodes[n].Right = this->Nodes.size() + 1;
+                this->Nodes.push_back( Node{ Begin, Middle, 0, 0, {}, {}, static_cast<T>(0), Mixed } );
+                this->Nodes.push_back( Node{ Middle, End, 0, 0, {}, {}, static_cast<T>(0), Mixed } );
+            }
+
+            this->Coordinates.resize(N);
+            this->Core.resize(N);
+            this->Components.resize(N);
+            for(size_t k = 0; k < N; ++k){
+                for(size_t d = 0; d < D; ++d) this->Coordinates[k][d] = Datum[this->Ids[k]]->Coordinates[d];
+                this->Core[k] = ComparableCore[this->Ids[k]];
+            }
+        }
+
+        //Records the component (e.g., disjoint set representative) of every datum, indexed by traversal index.
+        void UpdateComponents(const std::vector<size_t> &Component){
+            for(size_t k = 0; k < this->Ids.size(); ++k) this->Components[k] = Component[this->Ids[k]];
+            for(size_t n = this->Nodes.size(); n-- > 0; ){
+                Node &node = this->Nodes[n];
+                if(node.Left == 0){
+                    node.Component = this->Components[node.Begin];
+                    for(size_t k = node.Begin; k < node.End; ++k){
+                        if(this->Components[k] != node.Component){
+                            node.Component = Mixed;
+                            break;
+                        }
+                    }
+                }else{
+                    const size_t L = this->Nodes[node.Left].Component;
+                    node.Component = (L == this->Nodes[node.Right].Component) ? L : Mixed;
+                }
+            }
+            return;
+        }
+
+        //Finds the datum outside of datum i's component with the smallest mutual reachability distance to datum i.
+        // Ties are broken by the pair of traversal indices. Subtrees that cannot hold anything closer than the
+        // current value of Bound are skipped (ties are kept), so the result is only exact if it does not exceed the
+        // final value of Bound. Bound may be lowered concurrently by other threads.
+        //
+        // Returns the traversal index found, or the number of datum if none was found within Bound.
+        size_t NearestOtherComponent(const ClusteringDatum_t &P,
+                                     size_t i,
+                                     T CoreOfP,
+                                     size_t ComponentOfP,
+                                     const std::atomic<T> &Bound,
+                                     T &Reachability) const {
+            const size_t N = this->Ids.size();
+            std::array<T, D> X;
+            for(size_t d = 0; d < D; ++d) X[d] = P.Coordinates[d];
+
+            size_t Best = N;
+            T BestW = std::numeric_limits<T>::max();
+            auto Better = [&](T w, size_t j) -> bool {
+                if(w != BestW) return (w < BestW);
+                if(Best == N) return true;
+                const auto Key = std::make_pair(std::min(i, j), std::max(i, j));
+                return (Key < std::make_pair(std::min(i, Best), std::max(i, Best)));
+            };
+
+            std::vector<std::pair<T, size_t>> Stack;
+            Stack.reserve(64);
+            Stack.emplace_back( std::max<T>(CoreOfP, this->BoxLowerBound(X, this->Nodes[0])), 0 );
+            while(!Stack.empty()){
+                const auto Top = Stack.back();
+                Stack.pop_back();
+                const T Limit = std::min<T>(Bound.load(std::memory_order_relaxed), BestW);
+                if(Limit < Top.first) continue;
+
+                const Node &node = this->Nodes[Top.second];
+                if(node.Component == ComponentOfP) continue;
+
+                if(node.Left == 0){
+                    for(size_t k = node.Begin; k < node.End; ++k){
+                        if(this->Components[k] == ComponentOfP) continue;
+                        T A = static_cast<T>(0);
+                        for(size_t d = 0; d < D; ++d){
+                            A = DistanceMetric_t::Accumulate(A, static_cast<T>(this->Coordinates[k][d] - X[d]));
+                        }
+                        const T w = std::max<T>(std::max<T>(A, CoreOfP), this->Core[k]);
+                        if(Better(w, this->Ids[k])){
+                            BestW = w;
+                            Best = this->Ids[k];
+                        }
+                    }
+                }else{
+                    //Visit the nearer child first.
+                    const T L = std::max<T>(CoreOfP, this->BoxLowerBound(X, this->Nodes[node.Left]));
+                    const T R = std::max<T>(CoreOfP, this->BoxLowerBound(X, this->Nodes[node.Right]));
+                    if(L < R){
+                        Stack.emplace_back(R, node.Right);
+                        Stack.emplace_back(L, node.Left);
+                    }else{
+                        Stack.emplace_back(L, node.Left);
+                        Stack.emplace_back(R, node.Right);
+                    }
+                }
+            }
+            Reachability = BestW;
+            return Best;
+        }
+};
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+HDBSCANHierarchy<ClusteringDatum_t>
+    HDBSCANBuildHierarchy( const RTree_t & RTree,
+                           size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                           size_t MinClusterSize = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+                           size_t ThreadCount = DefaultClusteringThreadCount() ){
+
+    // This routine is an implementation of HDBSCAN*, described in the 2013 conference proceedings article
+    //   "Density-Based Clustering Based on Hierarchical Density Estimates" by Campello, Moulavi, and Sander.
+    //
+    // HDBSCAN* is a hierarchical extension of DBSCAN. Conceptually, it runs DBSCAN for every Eps at once and keeps
+    //   the clusters that persist over the widest range of densities. There is no Eps parameter, and clusters of
+    //   differing densities can be found in the same data.
+    //
+    // The procedure is as follows:
+    //   1. The core distance of every datum (the distance to its MinPts-th nearest datum) is found with a bounded
+    //      nearest-neighbour query against the R*-tree.
+    //   2. The minimum spanning tree of the 'mutual reachability' graph, where the weight of an edge is
+    //      max(core distance A, core distance B, distance A-B), is built with Boruvka's algorithm. Each round finds
+    //      the lightest edge leaving every component using a kd-tree that skips subtrees lying entirely within a
+    //      single component, so the complete graph is never formed.
+    //   3. The spanning tree is converted into a single-linkage dendrogram and then 'condensed': splits that shed
+    //      fewer than MinClusterSize datum are treated as datum falling out of a cluster rather than new clusters.
+    //   4. The stability of each condensed cluster is computed. Flat clusters can then be selected from the
+    //      hierarchy (see HDBSCANExtractLabels()).
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will not be modified.
+    // 2. MinPts --> Equivalent to the DBSCAN MinPts parameter; it controls how conservative the density estimate
+    //               is. Like DBSCAN(), the datum itself counts toward MinPts.
+    // 3. MinClusterSize --> The smallest group of datum considered a cluster. Must be >= 2.
+    // 4. ThreadCount --> The number of threads to use, including the calling thread.
+    //
+    // The distance metric can be changed via the DistanceMetric_t template parameter. See DBSCAN().
+    //
+    // NOTE: The spanning tree is unique (ties are broken by datum traversal index), so the result does not depend
+    //       on the number of threads.
+    //
+    // NOTE: Memory usage is linear in the number of datum. Boruvka needs O(log n) rounds, and components only
+    //       grow, so the nearest datum found for each datum is cached and reused until its component absorbs it.
+    //
+    typedef typename ClusteringDatum_t::SpatialType_ T;
+    typedef HDBSCANHierarchy<ClusteringDatum_t> HDBSCANHierarchy_t;
+
+    if(MinPts == 0) throw std::runtime_error("Parameter 'MinPts' must be >= 1.");
+    if(MinClusterSize < 2) throw std::runtime_error("Parameter 'MinClusterSize' must be >= 2.");
+
+    const std::string ThrowSelfPointCheck = "Spatial vicinity queries should always return the self point."
+                                            " This point is missing, indicating numerical stability issues"
+                                            " or logical errors in the spatial indexing approach.";
+    const std::string ThrowMinPtsTooLarge = "Parameter 'MinPts' was chosen too large. There are not enough"
+                                            " nearest-neighbours to permit this computation!";
+
+    const RTreeDatumIndex<RTree_t, ClusteringDatum_t> Index(RTree);
+    const size_t N = Index.size();
+
+    HDBSCANHierarchy_t out;
+    out.MinPts = MinPts;
+    out.MinClusterSize = MinClusterSize;
+    out.CoreDistance.resize(N);
+    if(N == 0) return out;
+
+    //Step 1: core distances.
+    std::vector<T> ComparableCore(N);
+    ParallelForEachIndex(N, ThreadCount, [&](size_t i) -> void {
+        T Core = 0;
+        const size_t Found = NearestNeighbourDistance<RTree_t, ClusteringDatum_t, DistanceMetric_t>(
+                                 RTree, *(Index.Datum[i]), MinPts, Core);
+        if(Found == 0) throw std::runtime_error(ThrowSelfPointCheck);
+        if(Found < MinPts) throw std::runtime_error(ThrowMinPtsTooLarge);
+        out.CoreDistance[i] = Core;
+        ComparableCore[i] = DistanceMetric_t::ToComparable(Core);
+    });
+
+    //Step 2: the minimum spanning tree, via Boruvka's algorithm.
+    //
+    // Every candidate edge is ordered by (weight, smaller index, larger index). This total order makes the lightest
+    // edge leaving each component unique, so merging along them can never form a cycle.
+    HDBSCANComponentTree<ClusteringDatum_t, DistanceMetric_t> Tree(Index.Datum, ComparableCore);
+
+    ConcurrentDisjointSets Sets(N);
+    std::vector<size_t> Component(N);
+    std::vector<size_t> Nearest(N, N);     //The lightest edge found for each datum in the current round.
+    std::vector<T> NearestW(N, static_cast<T>(0));
+    std::vector<uint8_t> Exact(N, 0);      //Whether Nearest is the lightest edge leaving the datum's component.
+    std::vector<T> LowerBound(N, static_cast<T>(0)); //Lower bound on the weight of any edge leaving the datum.
+    std::unique_ptr<std::atomic<T>[]> ComponentBound(new std::atomic<T>[N]);
+    std::vector<size_t> Work;
+    std::vector<std::pair<T, size_t>> Order;
+
+    auto AtomicMinimum = [](std::atomic<T> &a, T v) -> void {
+        T current = a.load(std::memory_order_relaxed);
+        while((v < current) && !a.compare_exchange_weak(current, v, std::memory_order_relaxed)){ }
+        return;
+    };
+    auto Lighter = [](T wa, size_t a0, size_t a1, T wb, size_t b0, size_t b1) -> bool {
+        if(wa != wb) return (wa < wb);
+        return std::make_pair(std::min(a0, a1), std::max(a0, a1)) < std::make_pair(std::min(b0, b1), std::max(b0, b1));
+    };
+
+    out.MinimumSpanningTree.reserve(N - 1);
+    for(;;){
+        size_t ComponentCount = 0;
+        for(size_t i = 0; i < N; ++i){
+            Component[i] = Sets.Find(i);
+            if(Component[i] == i){
+                ++ComponentCount;
+                ComponentBound[i].store(std::numeric_limits<T>::max(), std::memory_order_relaxed);
+            }
+        }
+        if(ComponentCount == 1) break;
+        Tree.UpdateComponents(Component);
+
+        //Edges found in earlier rounds remain the lightest for their datum if the other end is still elsewhere.
+        Order.clear();
+        for(size_t i = 0; i < N; ++i){
+            if(Nearest[i] != N){
+                if(Exact[i] && (Component[Nearest[i]] != Component[i])){
+                    AtomicMinimum(ComponentBound[Component[i]], NearestW[i]);
+                    continue;
+                }
+                if(Exact[i]) LowerBound[i] = std::max<T>(LowerBound[i], NearestW[i]);
+                Nearest[i] = N;
+            }
+            Order.emplace_back(std::max<T>(LowerBound[i], ComparableCore[i]), i);
+        }
+
+        //Search for the rest, most promising first so component bounds tighten early.
+        std::sort(Order.begin(), Order.end());
+        Work.clear();
+        for(const auto &o : Order) Work.push_back(o.second);
+        ParallelForEachIndex(Work.size(), ThreadCount, [&](size_t w) -> void {
+            const size_t i = Work[w];
+            const size_t c = Component[i];
+            auto &Bound = ComponentBound[c];
+            if(Bound.load(std::memory_order_relaxed) < std::max<T>(LowerBound[i], ComparableCore[i])) return;
+
+            T Reach = 0;
+            const size_t j = Tree.NearestOtherComponent(*(Index.Datum[i]), i, ComparableCore[i], c, Bound, Reach);
+            if(j != N) AtomicMinimum(Bound, Reach);
+            const T Final = Bound.load(std::memory_order_relaxed);
+            if((j != N) && !(Final < Reach)){
+                Nearest[i] = j;
+                NearestW[i] = Reach;
+                Exact[i] = 1;
+            }else{
+                //Everything not examined is heavier than Final. An edge that was found is still a real edge, so it
+                // can take part in this round, but it cannot be reused.
+                Nearest[i] = j;
+                NearestW[i] = Reach;
+                Exact[i] = 0;
+                LowerBound[i] = std::max<T>(LowerBound[i], std::min<T>(Final, Reach));
+            }
+        });
+
+        //Reduce to the lightest edge per component, then merge.
+        std::vector<size_t> Lightest(N, N);
+        for(size_t i = 0; i < N; ++i){
+            if(Nearest[i] == N) continue;
+            size_t &l = Lightest[Component[i]];
+            if((l == N) || Lighter(NearestW[i], i, Nearest[i], NearestW[l], l, Nearest[l])) l = i;
+        }
+        const size_t Before = out.MinimumSpanningTree.size();
+        for(size_t c = 0; c < N; ++c){
+            const size_t i = Lightest[c];
+            if(i == N) continue;
+            const size_t j = Nearest[i];
+            if(Sets.SameSet(i, j)) continue;
+            Sets.Union(i, j);
+            out.MinimumSpanningTree.push_back( { std::min(i, j), std::max(i, j),
+                                                 DistanceMetric_t::FromComparable(NearestW[i]) } );
+        }
+        if(Before == out.MinimumSpanningTree.size()){
+            throw std::runtime_error("Unable to connect spanning tree components. This indicates numerical issues.");
+        }
+    }
+    std::sort(out.MinimumSpanningTree.begin(), out.MinimumSpanningTree.end(),
+              [](const typename HDBSCANHierarchy_t::Edge &L, const typename HDBSCANHierarchy_t::Edge &R) -> bool {
+                  if(L.Distance != R.Distance) return (L.Distance < R.Distance);
+                  return std::make_pair(L.A, L.B) < std::make_pair(R.A, R.B);
+              });
+
+    //Step 3: the single-linkage dendrogram. Leaves are datum [0, N) and merges are numbered [N, 2N-1), in
+    // ascending order of distance, so the root is the last merge and children always precede their parents.
+    const size_t MergeCount = N - 1;
+    std::vector<size_t> Left(MergeCount), Right(MergeCount), Size(N + MergeCount, 1);
+    {
+        ConcurrentDisjointSets Linkage(N);
+        std::vector<size_t> Top(N);
+        std::iota(Top.begin(), Top.end(), static_cast<size_t>(0));
+        for(size_t m = 0; m < MergeCount; ++m){
+            const auto &e = out.MinimumSpanningTree[m];
+            const size_t a = Linkage.Find(e.A);
+            const size_t b = Linkage.Find(e.B);
+            Left[m] = Top[a];
+            Right[m] = Top[b];
+            Size[N + m] = Size[Top[a]] + Size[Top[b]];
+            Linkage.Union(a, b);
+            Top[Linkage.Find(a)] = N + m;
+        }
+    }
+
+    //Condense the dendrogram, walking from the root downward.
+    constexpr size_t None = std::numeric_limits<size_t>::max();
+    std::vector<size_t> Label(N + MergeCount, None);
+    std::vector<double> Birth;
+    if(MergeCount != 0){
+        Label[N + MergeCount - 1] = N;
+        Birth.push_back(0.0);
+    }
+    std::vector<size_t> FallStack;
+    auto FallOut = [&](size_t Node, size_t Parent, double Lambda) -> void {
+        FallStack.assign(1, Node);
+        while(!FallStack.empty()){
+            const size_t n = FallStack.back();
+            FallStack.pop_back();
+            if(n < N){
+                out.CondensedTree.push_back( { Parent, n, Lambda, 1 } );
+            }else{
+                FallStack.push_back(Left[n - N]);
+                FallStack.push_back(Right[n - N]);
+            }
+        }
+        return;
+    };
+    for(size_t m = MergeCount; m-- > 0; ){
+        const size_t Node = N + m;
+        if(Label[Node] == None) continue;
+        const size_t Parent = Label[Node];
+        const double Distance = static_cast<double>(out.MinimumSpanningTree[m].Distance);
+        const double Lambda = (0.0 < Distance) ? (1.0 / Distance) : std::numeric_limits<double>::max();
+        const size_t L = Left[m];
+        const size_t R = Right[m];
+        const bool BigL = (MinClusterSize <= Size[L]);
+        const bool BigR = (MinClusterSize <= Size[R]);
+        if(BigL && BigR){
+            for(const size_t Child : { L, R }){
+                Label[Child] = N + Birth.size();
+                Birth.push_back(Lambda);
+                out.CondensedTree.push_back( { Parent, Label[Child], Lambda, Size[Child] } );
+            }
+        }else if(!BigL && !BigR){
+            FallOut(L, Parent, Lambda);
+            FallOut(R, Parent, Lambda);
+        }else if(BigL){
+            Label[L] = Parent;
+            FallOut(R, Parent, Lambda);
+        }else{
+            Label[R] = Parent;
+            FallOut(L, Parent, Lambda);
+        }
+    }
+
+    //Step 4: cluster stability, the sum over member datum of how long (in lambda) they remained in the cluster.
+    out.ClusterStability.assign(Birth.size(), 0.0);
+    for(const auto &e : out.CondensedTree){
+        const size_t p = e.Parent - N;
+        out.ClusterStability[p] += (e.Lambda - Birth[p]) * static_cast<double>(e.ChildSize);
+    }
+    return out;
+}
+
+
+//This routine selects a flat clustering from an HDBSCAN* hierarchy using the 'excess of mass' criterion: a cluster
+// is kept in preference to its descendants unless their combined stability is larger. The root cluster (i.e., all
+// datum) is never selected. It returns one ClusterID per datum, in R*-tree traversal order.
+//
+// Datum that fall out of the hierarchy before reaching a selected cluster are labeled noise. Clusters are numbered
+// in order of their first datum in traversal order.
+//
+template < typename ClusteringDatum_t >
+std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> >
+    HDBSCANExtractLabels( const HDBSCANHierarchy<ClusteringDatum_t> & Hierarchy ){
+
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+    constexpr size_t None = std::numeric_limits<size_t>::max();
+
+    const size_t N = Hierarchy.CoreDistance.size();
+    const size_t C = Hierarchy.ClusterStability.size();
+    std::vector<ClusterID_t> Labels(N, ClusterID_t(ClusterID_t::Noise));
+    if(C == 0) return Labels;
+
+    std::vector<size_t> ParentOf(C, None);
+    std::vector<uint8_t> HasChildren(C, 0);
+    for(const auto &e : Hierarchy.CondensedTree){
+        if(e.Child < N) continue;
+        ParentOf[e.Child - N] = e.Parent - N;
+        HasChildren[e.Parent - N] = 1;
+    }
+
+    //Children are labeled after their parents, so a reverse sweep visits every child before its parent.
+    std::vector<uint8_t> Selected(C, 0);
+    std::vector<double> ChildStability(C, 0.0);
+    for(size_t c = C; c-- > 1; ){
+        double Best = Hierarchy.ClusterStability[c];
+        if(HasChildren[c] && (Best < ChildStability[c])){
+            Best = ChildStability[c];
+        }else{
+            Selected[c] = 1;
+        }
+        ChildStability[ParentOf[c]] += Best;
+    }
+
+    std::vector<size_t> SelectedAncestor(C, None);
+    for(size_t c = 1; c < C; ++c){
+        const size_t a = SelectedAncestor[ParentOf[c]];
+        SelectedAncestor[c] = (a != None) ? a : (Selected[c] ? c : None);
+    }
+
+    std::vector<size_t> Provisional(N, None);
+    for(const auto &e : Hierarchy.CondensedTree){
+        if(e.Child < N) Provisional[e.Child] = SelectedAncestor[e.Parent - N];
+    }
+
+    std::vector<ClusterID_t> Renumbered(C, ClusterID_t(ClusterID_t::Unclassified));
+    auto WorkingCID = ClusterID_t().NextValidClusterID();
+    bool Used = false;
+    for(size_t i = 0; i < N; ++i){
+        const size_t c = Provisional[i];
+        if(c == None) continue;
+        if(Renumbered[c].IsUnclassified()){
+            if(Used) WorkingCID = WorkingCID.NextValidClusterID();
+            Renumbered[c] = WorkingCID;
+            Used = true;
+        }
+        Labels[i] = Renumbered[c];
+    }
+    return Labels;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void HDBSCAN( const RTree_t & RTree,
+              std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > & Labels,
+              size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+              size_t MinClusterSize = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+              size_t ThreadCount = DefaultClusteringThreadCount() ){
+
+    // This routine performs HDBSCAN* and selects a flat clustering. ClusterIDs are written to the caller-provided
+    //   Labels vector, one per datum in R*-tree traversal order. See HDBSCANBuildHierarchy() for the parameters
+    //   and HDBSCANExtractLabels() for how clusters are selected.
+    //
+    // Use HDBSCANBuildHierarchy() directly to access the condensed cluster tree.
+    //
+    const auto Hierarchy = HDBSCANBuildHierarchy<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, MinPts,
+                                                                                                MinClusterSize,
+                                                                                                ThreadCount);
+    Labels = HDBSCANExtractLabels<ClusteringDatum_t>(Hierarchy);
+    return;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+void HDBSCAN( RTree_t & RTree,
+              size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+              size_t MinClusterSize = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+              size_t ThreadCount = DefaultClusteringThreadCount() ){
+
+    // This overload performs HDBSCAN* and writes the ClusterIDs into the datum in the R*-tree. See the const
+    //   overload.
+    //
+    const RTree_t &ConstRTree = RTree;
+    std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> > Labels;
+    HDBSCAN<RTree_t, ClusteringDatum_t, DistanceMetric_t>(ConstRTree, Labels, MinPts, MinClusterSize, ThreadCount);
+
+    size_t i = 0;
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&](const typename RTree_t::const_query_iterator &it) -> void {
+        const_cast<ClusteringDatum_t &>(*it).CID = Labels[i++];
+    });
+    return;
+}
+
+#endif //YGOR_CLUSTERING_HDBSCAN_HPP
@@ -78,6 +78,33 @@ void OnEachDatum( RTree_t & RTree,
 }
 
 
+//This is a helper function that builds a packed R*-tree from a collection of datum all at once. It should be
+// preferred over inserting datum one at a time whenever all datum are available up-front.
+//
+// Boost.Geometry's packing constructor is used, which sorts the datum with a Sort-Tile-Recursive-like partitioning
+// and fills each node completely. Compared with repeated rtree::insert() calls this (1) avoids the many datum copies
+// that occur during node splits and forced reinsertions, (2) is considerably faster, and (3) results in a balanced
+// tree with less node overlap, which speeds up subsequent queries (e.g., in DBSCAN()).
+//
+// Datum are copied into the tree, so the input can be discarded afterward.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename InputIterator_t >
+RTree_t BuildPackedRTree( InputIterator_t First,
+                          InputIterator_t Last,
+                          typename RTree_t::parameters_type Parameters = typename RTree_t::parameters_type() ){
+    return RTree_t(First, Last, Parameters);
+}
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t >
+RTree_t BuildPackedRTree( const std::vector<ClusteringDatum_t> & Datum,
+                          typename RTree_t::parameters_type Parameters = typename RTree_t::parameters_type() ){
+    return BuildPackedRTree<RTree_t, ClusteringDatum_t>(Datum.begin(), Datum.end(), Parameters);
+}
+
+
 //This helper function is a quick and dirty way to get a count (and unique list of) the ClusterIDs 
 // present in an R*-tree.
 template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
@@ -93,5 +120,63 @@ std::map< ClusterID<typename ClusteringDatum_t::ClusterIDType_>, size_t> GetClus
 }
 
 
+//This helper class assigns a dense integer index to every datum in an R*-tree. Datum are numbered in the order
+// that a full traversal of the tree visits them (i.e., the same order used by OnEachDatum() and DBSCAN()), and the
+// index of any datum returned by a query against the same tree can be recovered from its address.
+//
+// This is useful for algorithms that need per-datum scratch storage (e.g., flags, counts, or labels) that should
+// not live inside the R*-tree.
+//
+// NOTE: The index is invalidated if the R*-tree is modified in any way, since datum may be moved around.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t >
+class RTreeDatumIndex {
+    public:
+        std::vector<const ClusteringDatum_t *> Datum; //In traversal order.
+
+    private:
+        std::vector<std::pair<const ClusteringDatum_t *, size_t>> ByAddress; //Sorted for fast reverse lookups.
+
+    public:
+        explicit RTreeDatumIndex(const RTree_t &RTree){
+            //(Needed to work around missing RTree_t.begin()/end() when Boost.Geometry version < 1.58.0.)
+            constexpr auto RTreeQueryGetAll = [](const ClusteringDatum_t &) -> bool { return true; };
+
+            this->Datum.reserve(RTree.size());
+            typename RTree_t::const_query_iterator it;
+            it = RTree.qbegin(boost::geometry::index::satisfies( RTreeQueryGetAll ));
+            for( ; it != RTree.qend(); ++it){
+                this->Datum.push_back( std::addressof(*it) );
+            }
+
+            this->ByAddress.reserve(this->Datum.size());
+            for(size_t i = 0; i < this->Datum.size(); ++i) this->ByAddress.emplace_back( this->Datum[i], i );
+            std::sort(this->ByAddress.begin(), this->ByAddress.end(),
+                      [](const std::pair<const ClusteringDatum_t *, size_t> &L,
+                         const std::pair<const ClusteringDatum_t *, size_t> &R) -> bool {
+                          return std::less<const ClusteringDatum_t *>()(L.first, R.first);
+                      });
+        }
+
+        size_t size(void) const {
+            return this->Datum.size();
+        }
+
+        size_t IndexOf(const ClusteringDatum_t &in) const {
+            const auto *addr = std::addressof(in);
+            auto it = std::lower_bound(this->ByAddress.begin(), this->ByAddress.end(), addr,
+                                       [](const std::pair<const ClusteringDatum_t *, size_t> &L,
+                                          const ClusteringDatum_t *R) -> bool {
+                                           return std::less<const ClusteringDatum_t *>()(L.first, R);
+                                       });
+            if((it == this->ByAddress.end()) || (it->first != addr)){
+                throw std::runtime_error("Datum is not a member of the indexed R*-tree. Was the tree modified?");
+            }
+            return it->second;
+        }
+};
+
+
 
 #endif //YGOR_CLUSTERING_HELPERS_HPP
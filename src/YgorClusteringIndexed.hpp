@@ -0,0 +1,215 @@
+
+#ifndef YGOR_CLUSTERING_INDEXED_HPP
+#define YGOR_CLUSTERING_INDEXED_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <array>
+#include <limits>
+#include <utility>
+#include <cstdint>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/geometries/point.hpp>
+#include <boost/geometry/geometries/box.hpp>
+
+#include <boost/geometry/index/parameters.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringDatum.hpp"
+
+
+//A minimal point class for index-based clustering. It holds only spatial coordinates and the position of the datum
+// within a ClusteringStore (see below). Everything else about the datum (attributes, ClusterID, and user data)
+// lives in the store, outside of the R*-tree.
+//
+// Compared with ClusteringDatum, this keeps R*-tree nodes small and cheap to copy no matter how large or expensive
+// the user data is (e.g., strings or filesystem paths which would otherwise be heap-copied on every node split).
+//
+// The ClusterIDType is not stored in the point. It merely records which type of ClusterID the store uses.
+//
+template < std::size_t SpatialDimensionCount,   //For 3D data, this would be 3.
+           typename SpatialType,                //Generally a double.
+           typename ClusterIDType = uint32_t >  //The *underlying* type of the ClusterIDs held in the store.
+class IndexedClusteringPoint {
+    public:
+        //Type-defs and constants. (For accessibility after instantiation.)
+        constexpr static size_t SpatialDimensionCount_ = SpatialDimensionCount;
+        typedef SpatialType SpatialType_;
+        typedef typename ClusteringDistanceType<SpatialType>::type DistanceType_;
+        typedef ClusterIDType ClusterIDType_;
+        typedef uint32_t IndexType_;
+
+        //Data members.
+        std::array<SpatialType, SpatialDimensionCount> Coordinates; //For spatial indexing in the R*-tree.
+        IndexType_ Index; //Position of the datum within the ClusteringStore.
+
+        //Constructors.
+        IndexedClusteringPoint() : Index(0) {
+            this->Coordinates.fill( SpatialType() );
+        };
+        IndexedClusteringPoint(const decltype(Coordinates) &c, IndexType_ i) : Coordinates(c), Index(i) { };
+
+        //Member functions.
+        bool operator==(const IndexedClusteringPoint &in) const {
+            //Compare the index too, since distinct datum can share coordinates.
+            return (this->Index == in.Index) && (this->Coordinates == in.Coordinates);
+        }
+};
+
+
+//A structure-of-arrays container for datum that are clustered via IndexedClusteringPoints. Element 'i' of every
+// array describes the same datum, and IndexedClusteringPoint::Index refers to 'i'.
+//
+// Clustering routines that operate on a store (e.g., DBSCANIndexed()) write their results into the CIDs array.
+//
+template < std::size_t SpatialDimensionCount,   //For 3D data, this would be 3.
+           typename SpatialType,                //Generally a double.
+           std::size_t AttributeDimensionCount, //Depends on the user's needs. Probably 0 or 1.
+           typename AttributeType,              //Depends on the user's needs. Probably float or double.
+           typename ClusterIDType = uint32_t,   //The *underlying* type. Generally uint16_t or uint32_t.
+           typename UserDataClass = ClusteringUserDataEmptyClass > //Never copied into the R*-tree.
+class ClusteringStore {
+    public:
+        //Type-defs and constants. (For accessibility after instantiation.)
+        constexpr static size_t SpatialDimensionCount_ = SpatialDimensionCount;
+        typedef SpatialType SpatialType_;
+        typedef typename ClusteringDistanceType<SpatialType>::type DistanceType_;
+        constexpr static size_t AttributeDimensionCount_ = AttributeDimensionCount;
+        typedef AttributeType AttributeType_;
+        typedef ClusterIDType ClusterIDType_;
+        typedef UserDataClass UserDataClass_;
+        typedef IndexedClusteringPoint<SpatialDimensionCount, SpatialType, ClusterIDType> Point_t;
+
+        //Data members.
+        std::vector<std::array<SpatialType, SpatialDimensionCount>> Coordinates;
+        std::vector<std::array<AttributeType, AttributeDimensionCount>> Attributes;
+        std::vector<ClusterID<ClusterIDType>> CIDs;
+        std::vector<UserDataClass> UserData;
+
+        //Member functions.
+        size_t size(void) const {
+            return this->Coordinates.size();
+        }
+
+        void reserve(size_t n){
+            this->Coordinates.reserve(n);
+            this->Attributes.reserve(n);
+            this->CIDs.reserve(n);
+            this->UserData.reserve(n);
+            return;
+        }
+
+        //Appends a datum and returns its index.
+        size_t push_back(const std::array<SpatialType, SpatialDimensionCount> &c,
+                         const std::array<AttributeType, AttributeDimensionCount> &a = {},
+                         UserDataClass u = UserDataClass()){
+            if(static_cast<size_t>(std::numeric_limits<typename Point_t::IndexType_>::max()) <= this->size()){
+                throw std::runtime_error("Too many datum for an index-based clustering store.");
+            }
+            this->Coordinates.push_back(c);
+            this->Attributes.push_back(a);
+            this->CIDs.emplace_back();
+            this->UserData.push_back(std::move(u));
+            return this->size() - 1;
+        }
+
+        //Creates the point which stands in for datum 'i' inside the R*-tree.
+        Point_t Point(size_t i) const {
+            return Point_t(this->Coordinates.at(i), static_cast<typename Point_t::IndexType_>(i));
+        }
+};
+
+
+//This is a helper function that builds a packed R*-tree holding one IndexedClusteringPoint for every datum in a
+// ClusteringStore. See BuildPackedRTree().
+//
+// The R*-tree must be rebuilt if datum are added to the store afterward.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree of ClusteringStore_t::Point_t, specifically.
+           typename ClusteringStore_t >
+RTree_t BuildIndexedRTree( const ClusteringStore_t & Store,
+                           typename RTree_t::parameters_type Parameters = typename RTree_t::parameters_type() ){
+    std::vector<typename ClusteringStore_t::Point_t> Points;
+    Points.reserve(Store.size());
+    for(size_t i = 0; i < Store.size(); ++i) Points.push_back( Store.Point(i) );
+    return RTree_t(Points.begin(), Points.end(), Parameters);
+}
+
+
+//This code 'registers' the IndexedClusteringPoint class so it can be used as a Boost Geometry "point" type.
+namespace boost { namespace geometry { namespace traits {
+
+    template < std::size_t SpatialDimensionCount,
+               typename SpatialType,
+               typename ClusterIDType >
+    struct tag< IndexedClusteringPoint< SpatialDimensionCount, SpatialType, ClusterIDType > > {
+        typedef point_tag type;
+    };
+
+    template < std::size_t SpatialDimensionCount,
+               typename SpatialType,
+               typename ClusterIDType >
+    struct coordinate_type< IndexedClusteringPoint< SpatialDimensionCount, SpatialType, ClusterIDType > > {
+        typedef SpatialType type;
+    };
+
+    template < std::size_t SpatialDimensionCount,
+               typename SpatialType,
+               typename ClusterIDType >
+    struct coordinate_system< IndexedClusteringPoint< SpatialDimensionCount, SpatialType, ClusterIDType > > {
+        typedef boost::geometry::cs::cartesian type;
+    };
+
+    template < std::size_t SpatialDimensionCount,
+               typename SpatialType,
+               typename ClusterIDType >
+    struct dimension< IndexedClusteringPoint< SpatialDimensionCount, SpatialType, ClusterIDType > >
+        : boost::mpl::int_< SpatialDimensionCount > { };
+
+    template < std::size_t SpatialDimensionCount,
+               typename SpatialType,
+               typename ClusterIDType,
+               std::size_t ElementNumber >
+    struct access< IndexedClusteringPoint< SpatialDimensionCount, SpatialType, ClusterIDType >, ElementNumber > {
+
+        static inline SpatialType get(const IndexedClusteringPoint< SpatialDimensionCount,
+                                                                    SpatialType,
+                                                                    ClusterIDType > &in){
+            return std::get<ElementNumber>(in.Coordinates);
+        }
+
+        static inline void set(IndexedClusteringPoint< SpatialDimensionCount,
+                                                       SpatialType,
+                                                       ClusterIDType > &in,
+                               const SpatialType &val){
+            std::get<ElementNumber>(in.Coordinates) = val;
+            return;
+        }
+    };
+
+} } } // namespace boost::geometry::traits
+
+
+#endif //YGOR_CLUSTERING_INDEXED_HPP
@@ -0,0 +1,349 @@
+
+#ifndef YGOR_CLUSTERING_OPTICS_HPP
+#define YGOR_CLUSTERING_OPTICS_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <type_traits>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusterID.hpp"
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+
+
+//A binary min-heap over the integers [0, N) keyed by a distance. The position of every member is tracked, so keys
+// can be decreased in O(log N). Ties are broken by the smaller integer, which keeps results deterministic.
+template < typename Key_t >
+class IndexedMinHeap {
+    private:
+        static constexpr size_t NotPresent = std::numeric_limits<size_t>::max();
+
+        std::vector<std::pair<Key_t, size_t>> Heap;
+        std::vector<size_t> Position; //Position[i] is i's location in Heap, or NotPresent.
+
+        void Swap(size_t a, size_t b){
+            std::swap(this->Heap[a], this->Heap[b]);
+            this->Position[this->Heap[a].second] = a;
+            this->Position[this->Heap[b].second] = b;
+            return;
+        }
+
+        void SiftUp(size_t h){
+            while(h != 0){
+                const size_t parent = (h - 1) / 2;
+                if(!(this->Heap[h] < this->Heap[parent])) break;
+                this->Swap(h, parent);
+                h = parent;
+            }
+            return;
+        }
+
+        void SiftDown(size_t h){
+            const size_t n = this->Heap.size();
+            for(;;){
+                const size_t l = 2 * h + 1;
+                const size_t r = l + 1;
+                size_t smallest = h;
+                if((l < n) && (this->Heap[l] < this->Heap[smallest])) smallest = l;
+                if((r < n) && (this->Heap[r] < this->Heap[smallest])) smallest = r;
+                if(smallest == h) break;
+                this->Swap(h, smallest);
+                h = smallest;
+            }
+            return;
+        }
+
+    public:
+        explicit IndexedMinHeap(size_t N) : Position(N, NotPresent) { }
+
+        bool empty(void) const {
+            return this->Heap.empty();
+        }
+
+        bool contains(size_t i) const {
+            return (this->Position[i] != NotPresent);
+        }
+
+        //Inserts i, or lowers its key if it is already present and the new key is smaller.
+        void InsertOrDecrease(size_t i, Key_t k){
+            if(this->contains(i)){
+                const size_t h = this->Position[i];
+                if(!(k < this->Heap[h].first)) return;
+                this->Heap[h].first = k;
+                this->SiftUp(h);
+            }else{
+                this->Heap.emplace_back(k, i);
+                this->Position[i] = this->Heap.size() - 1;
+                this->SiftUp(this->Heap.size() - 1);
+            }
+            return;
+        }
+
+        size_t PopMinimum(void){
+            const size_t i = this->Heap.front().second;
+            this->Swap(0, this->Heap.size() - 1);
+            this->Heap.pop_back();
+            this->Position[i] = NotPresent;
+            if(!this->Heap.empty()) this->SiftDown(0);
+            return i;
+        }
+};
+
+
+//The output of OPTICS(). Datum are identified by their position in R*-tree traversal order (see RTreeDatumIndex).
+template < typename ClusteringDatum_t >
+struct OPTICSOrdering {
+    typedef typename ClusteringDatum_t::SpatialType_ SpatialType_;
+    static_assert(std::is_floating_point<SpatialType_>::value,
+                  "OPTICS requires floating-point coordinates. See ClusteringDistanceType.");
+
+    //Marks reachability and core distances that are undefined (i.e., larger than MaxEps).
+    static constexpr SpatialType_ Undefined = std::numeric_limits<SpatialType_>::has_infinity
+                                            ? std::numeric_limits<SpatialType_>::infinity()
+                                            : std::numeric_limits<SpatialType_>::max();
+
+    SpatialType_ MaxEps;
+    size_t MinPts;
+
+    std::vector<size_t> Order;                      //Traversal indices, in OPTICS cluster order.
+    std::vector<SpatialType_> ReachabilityDistance; //Indexed by traversal index.
+    std::vector<SpatialType_> CoreDistance;         //Indexed by traversal index.
+
+    //The smallest reachability distance from any core datum, regardless of the order datum were processed in, and
+    // the (traversal index of the) core datum it is measured from. Used to attach border datum to clusters.
+    std::vector<SpatialType_> SmallestReachabilityDistance;
+    std::vector<size_t> SmallestReachabilityCore;
+};
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+OPTICSOrdering<ClusteringDatum_t>
+    OPTICS( const RTree_t & RTree,
+            typename ClusteringDatum_t::SpatialType_ MaxEps,
+            size_t MinPts = ClusteringDatum_t::SpatialDimensionCount_ * 2,
+            SpatialQueryTechnique UsersSpatialQueryTechnique = SpatialQueryTechnique::UseWithin ){
+
+    // This routine is an implementation of the OPTICS algorithm described in the 1999 conference proceedings
+    //   article: "OPTICS: Ordering Points To Identify the Clustering Structure" by Ankerst, Breunig, Kriegel,
+    //   and Sander.
+    //
+    // OPTICS is closely related to DBSCAN. Rather than producing a single clustering for a single Eps, it produces
+    //   an ordering of the datum along with a 'reachability distance' for each. The resulting reachability plot
+    //   (reachability distance vs position in the ordering) shows clusters as valleys, and the DBSCAN clustering for
+    //   any Eps <= MaxEps can be extracted from it cheaply (see OPTICSExtractClusters()). So a single run can replace
+    //   the repeated DBSCAN runs otherwise needed to find a suitable Eps.
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The R*-tree already loaded with the data to be clustered. It will not be modified.
+    // 2. MaxEps --> The largest distance considered. Datum further apart are never considered directly reachable,
+    //               which bounds the cost of each neighbourhood query. Smaller values are faster, but clusterings
+    //               can only be extracted for Eps <= MaxEps.
+    // 3. MinPts --> Equivalent to the DBSCAN MinPts parameter. See DBSCAN().
+    // 4. SpatialQueryTechnique --> Specify the method used to find points in the vicinity of a given point.
+    //                              UseGrid is not supported, since neighbourhoods need to be enumerated.
+    //
+    // The distance metric can be changed via the DistanceMetric_t template parameter. See DBSCAN().
+    //
+    // NOTE: Like DBSCAN(), the datum itself counts toward MinPts, so the core distance is the distance to the
+    //       MinPts-th nearest datum including the datum itself.
+    //
+    // NOTE: Each datum is queried exactly once, and the reachability ordering is maintained with an indexed heap,
+    //       so the overall cost is one DBSCAN-like pass plus O(n log n).
+    //
+    typedef typename ClusteringDatum_t::SpatialType_ T;
+    typedef OPTICSOrdering<ClusteringDatum_t> OPTICSOrdering_t;
+
+    if(MinPts == 0) throw std::runtime_error("Parameter 'MinPts' must be >= 1.");
+
+    const RTreeDatumIndex<RTree_t, ClusteringDatum_t> Index(RTree);
+    const size_t N = Index.size();
+
+    OPTICSOrdering_t out;
+    out.MaxEps = MaxEps;
+    out.MinPts = MinPts;
+    out.Order.reserve(N);
+    out.ReachabilityDistance.assign(N, OPTICSOrdering_t::Undefined);
+    out.CoreDistance.assign(N, OPTICSOrdering_t::Undefined);
+    out.SmallestReachabilityDistance.assign(N, OPTICSOrdering_t::Undefined);
+    out.SmallestReachabilityCore.assign(N, N);
+
+    std::vector<uint8_t> Processed(N, 0);
+    IndexedMinHeap<T> Seeds(N);
+
+    //Scratch buffers, reused for every query.
+    std::vector<const ClusteringDatum_t *> Results;
+    std::vector<std::pair<size_t, T>> Neighbours;
+    std::vector<T> Distances;
+
+    //Queries the neighbourhood of datum i, records it as processed, and updates the seeds if it is a core datum.
+    auto Expand = [&](size_t i) -> void {
+        const ClusteringDatum_t &P = *(Index.Datum[i]);
+        Results.clear();
+        GatherDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, P, MaxEps,
+                                                                            UsersSpatialQueryTechnique, Results);
+        Processed[i] = 1;
+        out.Order.push_back(i);
+        if(Results.size() < MinPts) return;
+
+        Neighbours.clear();
+        Distances.clear();
+        for(const auto *r : Results){
+            const T d = MetricDistance<DistanceMetric_t>(P, *r);
+            Neighbours.emplace_back(Index.IndexOf(*r), d);
+            Distances.push_back(d);
+        }
+        std::nth_element(Distances.begin(), Distances.begin() + (MinPts - 1), Distances.end());
+        const T CoreDist = Distances[MinPts - 1];
+        out.CoreDistance[i] = CoreDist;
+
+        for(const auto &n : Neighbours){
+            const size_t j = n.first;
+            const T Reach = std::max(CoreDist, n.second);
+            if(Reach < out.SmallestReachabilityDistance[j]){
+                out.SmallestReachabilityDistance[j] = Reach;
+                out.SmallestReachabilityCore[j] = i;
+            }
+            if(Processed[j]) continue;
+            if(Reach < out.ReachabilityDistance[j]){
+                out.ReachabilityDistance[j] = Reach;
+                Seeds.InsertOrDecrease(j, Reach);
+            }
+        }
+        return;
+    };
+
+    for(size_t i = 0; i < N; ++i){
+        if(Processed[i]) continue;
+        Expand(i);
+        while(!Seeds.empty()) Expand(Seeds.PopMinimum());
+    }
+    return out;
+}
+
+
+//This routine extracts a DBSCAN-equivalent clustering for the given Eps from an OPTICS ordering. It returns one
+// ClusterID per datum, in R*-tree traversal order.
+//
+// Core datum (and noise) are labeled exactly as DBSCAN() would label them for the same Eps and MinPts, and clusters
+// are numbered in the same order. As with DBSCANParallel(), border datum reachable from two or more clusters may be
+// assigned differently.
+//
+// Core datum are grouped by walking the OPTICS ordering: a cluster begins at every core datum that is not reachable
+// (within Eps) from its predecessors. Border datum are attached afterward to the cluster of the core datum from
+// which they are most reachable. (The plain ordering walk would miss border datum that happened to be processed
+// before any of their core neighbours.)
+//
+template < typename ClusteringDatum_t >
+std::vector< ClusterID<typename ClusteringDatum_t::ClusterIDType_> >
+    OPTICSExtractLabels( const OPTICSOrdering<ClusteringDatum_t> & Ordering,
+                         typename ClusteringDatum_t::SpatialType_ Eps ){
+
+    typedef ClusterID<typename ClusteringDatum_t::ClusterIDType_> ClusterID_t;
+
+    if(Ordering.MaxEps < Eps) throw std::runtime_error("Requested Eps exceeds the OPTICS maximum Eps.");
+
+    //Distances are compared strictly, to match the DBSCAN neighbourhood definition.
+    const size_t N = Ordering.CoreDistance.size();
+    std::vector<size_t> Provisional(N, 0); //0 denotes noise.
+    size_t Current = 0;
+    size_t Clusters = 0;
+    for(const size_t i : Ordering.Order){
+        if(!(Ordering.ReachabilityDistance[i] < Eps)){
+            if(Ordering.CoreDistance[i] < Eps){
+                Current = ++Clusters;
+                Provisional[i] = Current;
+            }else{
+                Current = 0;
+            }
+        }else if(Ordering.CoreDistance[i] < Eps){
+            Provisional[i] = Current;
+        }
+    }
+    for(size_t i = 0; i < N; ++i){
+        if(!(Ordering.CoreDistance[i] < Eps) && (Ordering.SmallestReachabilityDistance[i] < Eps)){
+            Provisional[i] = Provisional[ Ordering.SmallestReachabilityCore[i] ];
+        }
+    }
+
+    //Renumber so clusters are ordered by their first core datum in traversal order, like DBSCAN().
+    std::vector<ClusterID_t> Renumbered(Clusters + 1, ClusterID_t(ClusterID_t::Unclassified));
+    auto WorkingCID = ClusterID_t().NextValidClusterID();
+    bool Used = false;
+    for(size_t i = 0; i < N; ++i){
+        const size_t c = Provisional[i];
+        if((c == 0) || !(Ordering.CoreDistance[i] < Eps) || !Renumbered[c].IsUnclassified()) continue;
+        if(Used) WorkingCID = WorkingCID.NextValidClusterID();
+        Renumbered[c] = WorkingCID;
+        Used = true;
+    }
+
+    std::vector<ClusterID_t> Labels(N, ClusterID_t(ClusterID_t::Noise));
+    for(size_t i = 0; i < N; ++i){
+        if(Provisional[i] != 0) Labels[i] = Renumbered[Provisional[i]];
+    }
+    return Labels;
+}
+
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t >
+void OPTICSExtractClusters( RTree_t & RTree,
+                            const OPTICSOrdering<ClusteringDatum_t> & Ordering,
+                            typename ClusteringDatum_t::SpatialType_ Eps ){
+
+    // This routine assigns ClusterIDs to the datum in the R*-tree using an OPTICS ordering. The result is
+    //   equivalent to running DBSCAN() with the given Eps and the MinPts used for OPTICS(). See
+    //   OPTICSExtractLabels().
+    //
+    // User parameters:
+    //
+    // 1. RTree --> The same (unmodified) R*-tree passed to OPTICS(). The CIDs will be modified in-place.
+    // 2. Ordering --> The output of OPTICS().
+    // 3. Eps --> DBSCAN algorithm parameter. Must not exceed the MaxEps used for OPTICS().
+    //
+    const auto Labels = OPTICSExtractLabels<ClusteringDatum_t>(Ordering, Eps);
+    if(Labels.size() != RTree.size()){
+        throw std::runtime_error("OPTICS ordering does not match the R*-tree. Was the tree modified?");
+    }
+
+    size_t i = 0;
+    OnEachDatum<RTree_t, ClusteringDatum_t>(RTree, [&](const typename RTree_t::const_query_iterator &it) -> void {
+        const_cast<ClusteringDatum_t &>(*it).CID = Labels[i++];
+    });
+    return;
+}
+
+#endif //YGOR_CLUSTERING_OPTICS_HPP
@@ -0,0 +1,174 @@
+
+#ifndef YGOR_CLUSTERING_OPTIONS_HPP
+#define YGOR_CLUSTERING_OPTIONS_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <functional>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <chrono>
+
+#include "YgorClusteringSpaceFillingCurve.hpp"
+
+
+//This exception is thrown by clustering routines that notice their cancellation token has been triggered. It derives
+// from std::runtime_error, so existing error handling will catch it, but can be caught separately to tell a
+// deliberate cancellation apart from a failure.
+class ClusteringCancelled : public std::runtime_error {
+    public:
+        ClusteringCancelled(void) : std::runtime_error("Clustering was cancelled.") { }
+};
+
+
+//A cancellation token shared between a clustering run and whoever may want to stop it. Copies share the same state,
+// so a token can be handed to a running (e.g., asynchronous) job and cancelled later from any thread.
+//
+// Cancellation is cooperative: routines check the token periodically and throw ClusteringCancelled when it has been
+// triggered. Any partially-written results should be discarded.
+//
+class ClusteringCancellationToken {
+    private:
+        std::shared_ptr<std::atomic<bool>> Flag;
+
+    public:
+        ClusteringCancellationToken(void) : Flag(std::make_shared<std::atomic<bool>>(false)) { }
+
+        void Cancel(void) const {
+            this->Flag->store(true, std::memory_order_relaxed);
+        }
+
+        bool IsCancelled(void) const {
+            return this->Flag->load(std::memory_order_relaxed);
+        }
+
+        void ThrowIfCancelled(void) const {
+            if(this->IsCancelled()) throw ClusteringCancelled();
+        }
+};
+
+
+//A snapshot of a clustering run's progress, passed to progress callbacks.
+struct ClusteringProgress {
+    double Fraction;     //Approximate fraction of the work completed, in [0,1].
+    size_t Classified;   //Datum that have been assigned to a cluster or marked as noise.
+    size_t Total;        //Datum being clustered.
+    size_t Clusters;     //Clusters discovered so far.
+};
+
+
+//Optional controls for long-running DBSCAN() calls.
+//
+// The progress callback is invoked at most once per ProgressInterval (and once more when the run completes). It may
+// be invoked from a worker thread, but never concurrently with itself. Exceptions it throws propagate out of the
+// clustering routine, so it can also be used to abort a run.
+//
+// The cancellation token is checked periodically, so a cancelled run stops within a few hundred spatial queries.
+//
+// The traversal order selects the order in which R*-tree-based routines visit datum (see ClusteringTraversalOrder).
+// Space-filling curve orders require sorting all datum first (using TraversalThreadCount threads). They mainly pay off
+// for DBSCANParallel() on large 3D R*-trees built by repeated insertion, where the R*-tree order is least coherent.
+// Bulk-loaded trees are already traversed in a spatially-coherent order, and DBSCAN() spends most of its time
+// expanding clusters (which follows the data, not the traversal order), so neither benefits. The order can change
+// which cluster a border datum joins and how clusters are numbered in DBSCAN(), but not in DBSCANParallel().
+//
+struct DBSCANOptions {
+    std::function<void(const ClusteringProgress &)> Progress;
+    std::chrono::duration<double> ProgressInterval = std::chrono::seconds(1);
+    ClusteringCancellationToken Cancellation;
+
+    ClusteringTraversalOrder TraversalOrder = ClusteringTraversalOrder::RTree;
+    size_t TraversalThreadCount = 1;
+};
+
+
+//This helper applies DBSCANOptions inside clustering routines. Routines call Checkpoint() often (e.g., once per
+// spatial query), but only every CheckInterval-th call actually examines the token or the clock, so checkpoints are
+// cheap. Nothing at all is done if no options were provided.
+//
+// Checkpoint() is safe to call concurrently from multiple threads.
+//
+class ClusteringProgressMonitor {
+    private:
+        static constexpr uint64_t CheckInterval = 256;
+
+        const DBSCANOptions *Options;
+        size_t TotalWork;
+        size_t TotalDatum;
+        std::atomic<uint64_t> Calls;
+        std::mutex ReportLock;
+        std::chrono::steady_clock::time_point LastReport;
+
+        void Report(size_t WorkDone, size_t Classified, size_t Clusters){
+            const double Fraction = (this->TotalWork == 0) ? 1.0
+                                  : std::min(1.0, static_cast<double>(WorkDone) / static_cast<double>(this->TotalWork));
+            this->Options->Progress( ClusteringProgress{ Fraction, Classified, this->TotalDatum, Clusters } );
+        }
+
+    public:
+        //TotalWork is the number of work units (e.g., datum to classify) that WorkDone counts towards.
+        ClusteringProgressMonitor(const DBSCANOptions *O, size_t Datum, size_t Work)
+            : Options(O), TotalWork(Work), TotalDatum(Datum), Calls(0), LastReport(std::chrono::steady_clock::now()) { }
+
+        ClusteringProgressMonitor(const DBSCANOptions *O, size_t Datum)
+            : ClusteringProgressMonitor(O, Datum, Datum) { }
+
+        ClusteringProgressMonitor(const ClusteringProgressMonitor &) = delete;
+        ClusteringProgressMonitor & operator=(const ClusteringProgressMonitor &) = delete;
+
+        bool IsActive(void) const {
+            return (this->Options != nullptr);
+        }
+
+        //Checks the token immediately, regardless of how often it has been checked.
+        void ThrowIfCancelled(void) const {
+            if(this->Options != nullptr) this->Options->Cancellation.ThrowIfCancelled();
+        }
+
+        void Checkpoint(size_t WorkDone, size_t Classified, size_t Clusters){
+            if(this->Options == nullptr) return;
+            if(((this->Calls.fetch_add(1, std::memory_order_relaxed) + 1) % CheckInterval) != 0) return;
+            this->Options->Cancellation.ThrowIfCancelled();
+            if(!this->Options->Progress) return;
+
+            std::unique_lock<std::mutex> lock(this->ReportLock, std::try_to_lock);
+            if(!lock.owns_lock()) return;
+            const auto Now = std::chrono::steady_clock::now();
+            if((Now - this->LastReport) < this->Options->ProgressInterval) return;
+            this->LastReport = Now;
+            this->Report(WorkDone, Classified, Clusters);
+        }
+
+        //Reports completion. This is not rate-limited.
+        void Finish(size_t Classified, size_t Clusters){
+            if((this->Options == nullptr) || !this->Options->Progress) return;
+            std::lock_guard<std::mutex> lock(this->ReportLock);
+            this->Report(this->TotalWork, Classified, Clusters);
+        }
+};
+
+#endif //YGOR_CLUSTERING_OPTIONS_HPP
@@ -0,0 +1,205 @@
+
+#ifndef YGOR_CLUSTERING_PARALLEL_HPP
+#define YGOR_CLUSTERING_PARALLEL_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <vector>
+#include <limits>
+#include <utility>
+#include <memory>
+#include <algorithm>
+#include <exception>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+
+//Returns a sane number of worker threads to use when the user has not specified one.
+inline size_t DefaultClusteringThreadCount(void){
+    const auto n = std::thread::hardware_concurrency();
+    return (n == 0) ? 1 : static_cast<size_t>(n);
+}
+
+
+//This helper function invokes a user function once for every index in [0, N) using a number of worker threads.
+// Indices are handed out dynamically in small chunks so uneven per-index workloads (e.g., dense vs sparse regions
+// of a point cloud) are balanced across threads. The order in which indices are visited is unspecified.
+//
+// User functions should be of the sort:
+//     std::function<void(size_t)>;
+// and must be safe to call concurrently.
+//
+// The chunk size should be reduced when individual indices represent large amounts of work.
+//
+// If any invocation throws, remaining work is abandoned and the first exception is re-thrown in the calling thread.
+//
+template < typename IndexOperation_t >
+void ParallelForEachIndex( size_t N,
+                           size_t ThreadCount,
+                           IndexOperation_t OpFunc,
+                           size_t ChunkSize = 256 ){
+
+    if(ThreadCount == 0) ThreadCount = 1;
+    if(ChunkSize == 0) ChunkSize = 1;
+    ThreadCount = std::min(ThreadCount, (N + ChunkSize - 1) / ChunkSize);
+
+    //Avoid thread overhead entirely when there is not enough work to share.
+    if(ThreadCount <= 1){
+        for(size_t i = 0; i < N; ++i) OpFunc(i);
+        return;
+    }
+
+    std::atomic<size_t> NextChunk(0);
+    std::atomic<bool> Abort(false);
+    std::exception_ptr FirstException;
+    std::mutex FirstExceptionLock;
+
+    auto Worker = [&](void) -> void {
+        try{
+            while(!Abort.load(std::memory_order_relaxed)){
+                const size_t Begin = NextChunk.fetch_add(ChunkSize, std::memory_order_relaxed);
+                if(N <= Begin) break;
+                const size_t End = std::min(N, Begin + ChunkSize);
+                for(size_t i = Begin; i < End; ++i) OpFunc(i);
+            }
+        }catch(...){
+            std::lock_guard<std::mutex> lock(FirstExceptionLock);
+            if(!FirstException) FirstException = std::current_exception();
+            Abort.store(true);
+        }
+        return;
+    };
+
+    std::vector<std::thread> Workers;
+    Workers.reserve(ThreadCount - 1);
+    for(size_t t = 1; t < ThreadCount; ++t) Workers.emplace_back(Worker);
+    Worker(); //The calling thread participates too.
+    for(auto &w : Workers) w.join();
+
+    if(FirstException) std::rethrow_exception(FirstException);
+    return;
+}
+
+
+//This helper function sorts a random-access range using a number of worker threads. The range is split into one
+// contiguous block per thread, the blocks are sorted concurrently, and then adjacent blocks are merged pairwise
+// (also concurrently) until a single sorted run remains.
+//
+// The sort is not stable.
+//
+template < typename RandomIt_t,
+           typename Compare_t >
+void ParallelSort( RandomIt_t First,
+                   RandomIt_t Last,
+                   Compare_t Comp,
+                   size_t ThreadCount ){
+
+    const size_t N = static_cast<size_t>(std::distance(First, Last));
+    constexpr size_t MinimumBlockSize = 16384;
+    if(ThreadCount == 0) ThreadCount = 1;
+    ThreadCount = std::min(ThreadCount, N / MinimumBlockSize);
+    if(ThreadCount <= 1){
+        std::sort(First, Last, Comp);
+        return;
+    }
+
+    //Block b spans [Bounds[b], Bounds[b+1]).
+    std::vector<size_t> Bounds;
+    for(size_t b = 0; b <= ThreadCount; ++b) Bounds.push_back( (N * b) / ThreadCount );
+
+    ParallelForEachIndex(ThreadCount, ThreadCount, [&](size_t b) -> void {
+        std::sort(First + Bounds[b], First + Bounds[b + 1], Comp);
+    }, 1);
+
+    while(Bounds.size() > 2){
+        const size_t Pairs = (Bounds.size() - 1) / 2;
+        ParallelForEachIndex(Pairs, ThreadCount, [&](size_t p) -> void {
+            std::inplace_merge(First + Bounds[2 * p], First + Bounds[2 * p + 1], First + Bounds[2 * p + 2], Comp);
+        }, 1);
+
+        std::vector<size_t> Merged;
+        for(size_t b = 0; b < Bounds.size(); b += 2) Merged.push_back(Bounds[b]);
+        if(Merged.back() != Bounds.back()) Merged.push_back(Bounds.back());
+        Bounds.swap(Merged);
+    }
+    return;
+}
+
+
+//A lock-free disjoint-set forest (i.e., union-find) over the integers [0, N).
+//
+// Find() and Union() may be called concurrently from any number of threads. Roots are always linked so that the
+// smaller index becomes the parent, so once all Union() calls have completed the representative of every set is the
+// smallest index in the set. This makes the final partition, and its representatives, independent of thread
+// scheduling.
+//
+class ConcurrentDisjointSets {
+    private:
+        std::unique_ptr<std::atomic<size_t>[]> Parent;
+        size_t N;
+
+    public:
+        explicit ConcurrentDisjointSets(size_t n) : Parent(new std::atomic<size_t>[n]), N(n) {
+            for(size_t i = 0; i < N; ++i) Parent[i].store(i, std::memory_order_relaxed);
+        }
+
+        size_t size(void) const {
+            return this->N;
+        }
+
+        size_t Find(size_t i){
+            //Path halving. Failed compare-exchanges are harmless; another thread has already shortened the path.
+            for(;;){
+                size_t p = Parent[i].load(std::memory_order_acquire);
+                if(p == i) return i;
+                const size_t gp = Parent[p].load(std::memory_order_acquire);
+                if(p != gp) Parent[i].compare_exchange_weak(p, gp, std::memory_order_acq_rel);
+                i = gp;
+            }
+        }
+
+        void Union(size_t a, size_t b){
+            for(;;){
+                a = this->Find(a);
+                b = this->Find(b);
+                if(a == b) return;
+                if(a < b) std::swap(a, b);
+
+                //Attempt to hang the larger root beneath the smaller one. Retry if 'a' stopped being a root.
+                size_t expected = a;
+                if(Parent[a].compare_exchange_strong(expected, b, std::memory_order_acq_rel)) return;
+            }
+        }
+
+        bool SameSet(size_t a, size_t b){
+            for(;;){
+                a = this->Find(a);
+                b = this->Find(b);
+                if(a == b) return true;
+                //Only trust a negative answer if 'a' is still a root; otherwise a concurrent Union() intervened.
+                if(Parent[a].load(std::memory_order_acquire) == a) return false;
+            }
+        }
+};
+
+
+#endif //YGOR_CLUSTERING_PARALLEL_HPP
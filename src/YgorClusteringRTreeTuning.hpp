@@ -0,0 +1,238 @@
+
+#ifndef YGOR_CLUSTERING_RTREETUNING_HPP
+#define YGOR_CLUSTERING_RTREETUNING_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <iostream>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/parameters.hpp>
+#include <boost/geometry/index/rtree.hpp>
+
+#include "YgorClusteringHelpers.hpp"
+#include "YgorClusteringMetrics.hpp"
+#include "YgorClusteringDBSCAN.hpp"
+
+
+//A compile-time list of Boost.Geometry R-tree parameter types (e.g., boost::geometry::index::rstar<16>) to try.
+template < typename... RTreeParameters_t >
+struct RTreeParameterList { };
+
+typedef RTreeParameterList< boost::geometry::index::linear<8>,
+                            boost::geometry::index::linear<16>,
+                            boost::geometry::index::linear<32>,
+                            boost::geometry::index::linear<64>,
+                            boost::geometry::index::quadratic<8>,
+                            boost::geometry::index::quadratic<16>,
+                            boost::geometry::index::quadratic<32>,
+                            boost::geometry::index::quadratic<64>,
+                            boost::geometry::index::rstar<4>,
+                            boost::geometry::index::rstar<6>,
+                            boost::geometry::index::rstar<8>,
+                            boost::geometry::index::rstar<16>,
+                            boost::geometry::index::rstar<32>,
+                            boost::geometry::index::rstar<64>,
+                            boost::geometry::index::rstar<128> > DefaultRTreeTuningCandidates;
+
+
+//Names R-tree parameter types as they would be written in code, so the best one can be pasted into a typedef.
+template < typename RTreeParameter_t >
+struct RTreeParameterName;
+
+template < size_t MaxElements, size_t MinElements >
+struct RTreeParameterName< boost::geometry::index::linear<MaxElements, MinElements> > {
+    static std::string Get(void){
+        return "boost::geometry::index::linear<" + std::to_string(MaxElements) + ">";
+    }
+};
+
+template < size_t MaxElements, size_t MinElements >
+struct RTreeParameterName< boost::geometry::index::quadratic<MaxElements, MinElements> > {
+    static std::string Get(void){
+        return "boost::geometry::index::quadratic<" + std::to_string(MaxElements) + ">";
+    }
+};
+
+template < size_t MaxElements, size_t MinElements, size_t ReinsertedElements, size_t OverlapCostThreshold >
+struct RTreeParameterName< boost::geometry::index::rstar<MaxElements, MinElements,
+                                                         ReinsertedElements, OverlapCostThreshold> > {
+    static std::string Get(void){
+        return "boost::geometry::index::rstar<" + std::to_string(MaxElements) + ">";
+    }
+};
+
+
+//How candidate trees are constructed during tuning.
+enum class RTreeTuningBuild {
+    Packed,   //Bulk-loaded, as with BuildPackedRTree(). The balancing algorithm only affects later insertions.
+    Inserted  //Datum are inserted one at a time, as with DBSCANIncremental or user-managed trees.
+};
+
+
+//Timings for a single candidate R-tree parameter type.
+struct RTreeTuningResult {
+    std::string Parameters;    //The parameter type, e.g., "boost::geometry::index::rstar<16>".
+    size_t MaxElements;
+    double BuildSeconds;       //Time to construct the tree from the sample.
+    double QuerySeconds;       //Mean time for a single Eps range query, averaged over all Eps values.
+    double EstimatedSeconds;   //BuildSeconds plus one query per sampled datum, i.e., roughly one DBSCAN run.
+};
+
+
+template < typename ClusteringDatum_t,
+           typename DistanceMetric_t,
+           typename RTreeParameter_t >
+RTreeTuningResult RTreeTuningTrial( const std::vector<ClusteringDatum_t> & Sample,
+                                    const std::vector<typename ClusteringDatum_t::SpatialType_> & EpsValues,
+                                    const std::vector<size_t> & Queries,
+                                    RTreeTuningBuild Build ){
+    typedef boost::geometry::index::rtree<ClusteringDatum_t, RTreeParameter_t> RTree_t;
+
+    RTreeTuningResult out;
+    out.Parameters = RTreeParameterName<RTreeParameter_t>::Get();
+    out.MaxElements = RTreeParameter_t::max_elements;
+
+    const auto BuildStart = std::chrono::steady_clock::now();
+    RTree_t RTree;
+    if(Build == RTreeTuningBuild::Packed){
+        RTree = BuildPackedRTree<RTree_t, ClusteringDatum_t>(Sample);
+    }else{
+        for(const auto &d : Sample) RTree.insert(d);
+    }
+    out.BuildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - BuildStart).count();
+
+    //Queries are repeated and the fastest repetition is kept, which suppresses most timing noise.
+    constexpr size_t Repetitions = 3;
+    size_t Found = 0;
+    out.QuerySeconds = 0.0;
+    for(const auto Eps : EpsValues){
+        double Best = std::numeric_limits<double>::infinity();
+        for(size_t r = 0; r < Repetitions; ++r){
+            const auto QueryStart = std::chrono::steady_clock::now();
+            for(const auto i : Queries){
+                OnEachDatumWithinEps<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Sample[i], Eps,
+                    SpatialQueryTechnique::UseWithin,
+                    [&Found](const ClusteringDatum_t &) -> void { ++Found; });
+            }
+            Best = std::min(Best, std::chrono::duration<double>(std::chrono::steady_clock::now() - QueryStart).count());
+        }
+        out.QuerySeconds += Best / static_cast<double>(Queries.size());
+    }
+    out.QuerySeconds /= static_cast<double>(EpsValues.size());
+    if(Found == 0) throw std::runtime_error("Spatial queries found no datum, not even the query datum.");
+
+    out.EstimatedSeconds = out.BuildSeconds + out.QuerySeconds * static_cast<double>(Sample.size());
+    return out;
+}
+
+template < typename ClusteringDatum_t,
+           typename DistanceMetric_t,
+           typename... RTreeParameters_t >
+std::vector<RTreeTuningResult> RTreeTuningTrials( RTreeParameterList<RTreeParameters_t...>,
+                                                  const std::vector<ClusteringDatum_t> & Sample,
+                                                  const std::vector<typename ClusteringDatum_t::SpatialType_> & EpsValues,
+                                                  const std::vector<size_t> & Queries,
+                                                  RTreeTuningBuild Build ){
+    return { RTreeTuningTrial<ClusteringDatum_t, DistanceMetric_t, RTreeParameters_t>(Sample, EpsValues,
+                                                                                      Queries, Build)... };
+}
+
+
+template < typename ClusteringDatum_t,
+           typename Candidates_t = DefaultRTreeTuningCandidates,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+std::vector<RTreeTuningResult>
+    TuneRTreeParameters( const std::vector<ClusteringDatum_t> & Sample,
+                         const std::vector<typename ClusteringDatum_t::SpatialType_> & EpsValues,
+                         size_t QueryCount = 10'000,
+                         RTreeTuningBuild Build = RTreeTuningBuild::Packed,
+                         std::ostream *ReportStream = nullptr,
+                         uint64_t Seed = 9137 ){
+
+    // This routine helps select the R-tree balancing algorithm and node capacity (i.e., the RTreeParameter_t used
+    //   to define RTree_t) for a given kind of data. A tree is built from the sample with each candidate parameter
+    //   type, and a random subset of the sample is used to time Eps range queries like those DBSCAN() performs.
+    //
+    // User parameters:
+    //
+    // 1. Sample --> A representative sample of the data to be clustered, e.g., 10^5 datum drawn at random. The
+    //               sample should have the same density as the full data, so it is better to sample a sub-region
+    //               than to thin the data uniformly.
+    // 2. EpsValues --> The Eps values that will be used for clustering. Query timings are averaged over them.
+    // 3. QueryCount --> The number of sampled datum used as query points for each Eps.
+    // 4. Build --> Whether candidate trees are bulk-loaded (like BuildPackedRTree()) or built by insertion.
+    // 5. ReportStream --> If provided, a table of results and the best parameter type are printed to it.
+    // 6. Seed --> Seeds the selection of query datum, so repeated runs time the same queries.
+    //
+    // Results are returned sorted by EstimatedSeconds, so the first entry is the recommended parameter type. Its
+    //   Parameters member is written the way it would appear in code, e.g.:
+    //     typedef boost::geometry::index::rstar<16> RTreeParameter_t;
+    //
+    // NOTE: Timings depend on the hardware, so tuning should be performed on the machine that will do the
+    //       clustering. Differences of a few percent between candidates are generally not meaningful.
+    //
+    // NOTE: Candidates are provided at compile-time via an RTreeParameterList. Add or remove candidates by
+    //       passing a different list, e.g., RTreeParameterList< boost::geometry::index::rstar<24> >.
+    //
+    if(Sample.empty()) throw std::runtime_error("Cannot tune R-tree parameters with an empty sample.");
+    if(EpsValues.empty()) throw std::runtime_error("At least one Eps value is required to tune R-tree parameters.");
+    if(QueryCount == 0) throw std::runtime_error("At least one query is required to tune R-tree parameters.");
+
+    std::vector<size_t> Queries(Sample.size());
+    for(size_t i = 0; i < Queries.size(); ++i) Queries[i] = i;
+    if(QueryCount < Sample.size()){
+        std::mt19937_64 re(Seed);
+        std::shuffle(Queries.begin(), Queries.end(), re);
+        Queries.resize(QueryCount);
+    }
+
+    auto out = RTreeTuningTrials<ClusteringDatum_t, DistanceMetric_t>(Candidates_t(), Sample, EpsValues,
+                                                                      Queries, Build);
+    std::stable_sort(out.begin(), out.end(), [](const RTreeTuningResult &A, const RTreeTuningResult &B) -> bool {
+        return (A.EstimatedSeconds < B.EstimatedSeconds);
+    });
+
+    if(ReportStream != nullptr){
+        auto &os = *ReportStream;
+        os << "R-tree tuning with " << Sample.size() << " datum and " << Queries.size() << " queries per Eps:"
+           << std::endl;
+        for(const auto &r : out){
+            os << "  " << r.Parameters
+               << "\t build: " << r.BuildSeconds << " s"
+               << "\t query: " << (r.QuerySeconds * 1.0E6) << " us"
+               << "\t estimated: " << r.EstimatedSeconds << " s" << std::endl;
+        }
+        os << "Recommended: typedef " << out.front().Parameters << " RTreeParameter_t;" << std::endl;
+    }
+    return out;
+}
+
+#endif //YGOR_CLUSTERING_RTREETUNING_HPP
@@ -0,0 +1,227 @@
+
+#ifndef YGOR_CLUSTERING_RADIUSQUERY_HPP
+#define YGOR_CLUSTERING_RADIUSQUERY_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+#include <boost/geometry.hpp>
+#include <boost/geometry/index/rtree.hpp>
+#include <boost/geometry/index/detail/rtree/utilities/view.hpp>
+
+#include "YgorClusteringMetrics.hpp"
+
+
+//This class is a Boost.Geometry R*-tree visitor that performs a true radius (i.e., hyper-sphere) query. Child nodes
+// are only descended into if the minimum distance from the query datum to their bounding box is less than Eps, and
+// datum in leaves are passed to the user function if they are strictly closer than Eps.
+//
+// Unlike a bounding-box query, nodes that overlap the box but not the sphere are pruned, and no datum are returned
+// that must later be discarded. Unlike a nearest-neighbour query, no priority queue is maintained.
+//
+// User functions should be of the sort:
+//     std::function<bool(const ClusteringDatum_t &)>;
+// and return false to stop the query, e.g., once enough datum have been found.
+//
+// The optional CandidateOp functor is invoked (with no arguments) once for every datum whose distance is evaluated.
+//
+// NOTE: Distances are measured with the given metric policy. The minimum distance to a box is accumulated from the
+//       per-axis gaps, which is exact for all metrics provided in YgorClusteringMetrics.hpp.
+//
+// NOTE: This relies on Boost.Geometry's (undocumented) node visitor interface, which is also used by Boost's own
+//       R*-tree utilities. Use VisitDatumWithinRadius() below rather than this class directly.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t,
+           typename DatumOperation_t,
+           typename CandidateOperation_t >
+class RadiusQueryVisitor
+    : public boost::geometry::index::detail::rtree::visitor<
+                 typename boost::geometry::index::detail::rtree::utilities::view<RTree_t>::value_type,
+                 typename boost::geometry::index::detail::rtree::utilities::view<RTree_t>::options_type::parameters_type,
+                 typename boost::geometry::index::detail::rtree::utilities::view<RTree_t>::box_type,
+                 typename boost::geometry::index::detail::rtree::utilities::view<RTree_t>::allocators_type,
+                 typename boost::geometry::index::detail::rtree::utilities::view<RTree_t>::options_type::node_tag,
+                 true >::type {
+    public:
+        typedef boost::geometry::index::detail::rtree::utilities::view<RTree_t> View_t;
+        typedef typename View_t::value_type Value_t;
+        typedef typename View_t::options_type::parameters_type Parameters_t;
+        typedef typename View_t::box_type Box_t;
+        typedef typename View_t::allocators_type Allocators_t;
+        typedef typename View_t::options_type::node_tag NodeTag_t;
+        typedef typename boost::geometry::index::detail::rtree::internal_node<
+                    Value_t, Parameters_t, Box_t, Allocators_t, NodeTag_t >::type internal_node;
+        typedef typename boost::geometry::index::detail::rtree::leaf<
+                    Value_t, Parameters_t, Box_t, Allocators_t, NodeTag_t >::type leaf;
+
+        static_assert(std::is_same<Value_t, ClusteringDatum_t>::value,
+                      "The R*-tree must hold ClusteringDatum_t directly.");
+
+        typedef typename ClusteringDatum_t::DistanceType_ T;
+        static constexpr size_t D = ClusteringDatum_t::SpatialDimensionCount_;
+
+    private:
+        std::array<T, D> Query;
+        T Threshold;
+        DatumOperation_t &OpFunc;
+        CandidateOperation_t &CandidateOp;
+
+        template <size_t... d>
+        T BoxComparableDistance(const Box_t &B, std::index_sequence<d...>) const {
+            T Acc = static_cast<T>(0);
+            ( (Acc = DistanceMetric_t::Accumulate(Acc, Gap(this->Query[d],
+                            static_cast<T>(boost::geometry::get<boost::geometry::min_corner, d>(B)),
+                            static_cast<T>(boost::geometry::get<boost::geometry::max_corner, d>(B))))), ... );
+            return Acc;
+        }
+
+        static T Gap(T q, T Lower, T Upper){
+            return (q < Lower) ? (Lower - q)
+                 : (Upper < q) ? (q - Upper)
+                               : static_cast<T>(0);
+        }
+
+    public:
+        bool Stopped = false;
+
+        RadiusQueryVisitor(const ClusteringDatum_t &Q, T Eps, DatumOperation_t &F, CandidateOperation_t &C)
+            : Threshold( DistanceMetric_t::ToComparable(Eps) ), OpFunc(F), CandidateOp(C) {
+            for(size_t d = 0; d < D; ++d) this->Query[d] = static_cast<T>(Q.Coordinates[d]);
+        }
+
+        void operator()(const internal_node &n){
+            for(const auto &e : boost::geometry::index::detail::rtree::elements(n)){
+                if(this->Stopped) return;
+                if(this->BoxComparableDistance(e.first, std::make_index_sequence<D>()) < this->Threshold){
+                    boost::geometry::index::detail::rtree::apply_visitor(*this, *(e.second));
+                }
+            }
+            return;
+        }
+
+        void operator()(const leaf &n){
+            for(const auto &v : boost::geometry::index::detail::rtree::elements(n)){
+                this->CandidateOp();
+                T Acc = static_cast<T>(0);
+                for(size_t d = 0; d < D; ++d){
+                    Acc = DistanceMetric_t::Accumulate(Acc, static_cast<T>(v.Coordinates[d]) - this->Query[d]);
+                }
+                if((Acc < this->Threshold) && !this->OpFunc(v)){
+                    this->Stopped = true;
+                    return;
+                }
+            }
+            return;
+        }
+};
+
+
+//This helper function applies a user function to each datum in the R*-tree that is strictly closer than Eps to the
+// query datum, until the user function returns false. The query datum itself is included if it is a member of the
+// tree. Returns true if the whole neighbourhood was visited, i.e., the query was not stopped early.
+//
+// Only read access to the tree is required, so it is safe to call concurrently from multiple threads as long as
+// nobody modifies the tree. See RadiusQueryVisitor.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename DatumOperation_t,
+           typename CandidateOperation_t >
+bool VisitDatumWithinRadius( const RTree_t & RTree,
+                             const ClusteringDatum_t & Query,
+                             typename ClusteringDatum_t::DistanceType_ Eps,
+                             DatumOperation_t OpFunc,
+                             CandidateOperation_t CandidateOp ){
+    RadiusQueryVisitor<RTree_t, ClusteringDatum_t, DistanceMetric_t, DatumOperation_t, CandidateOperation_t>
+        Visitor(Query, Eps, OpFunc, CandidateOp);
+    const boost::geometry::index::detail::rtree::utilities::view<RTree_t> View(RTree);
+    View.apply_visitor(Visitor);
+    return !Visitor.Stopped;
+}
+
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename DatumOperation_t >
+bool VisitDatumWithinRadius( const RTree_t & RTree,
+                             const ClusteringDatum_t & Query,
+                             typename ClusteringDatum_t::DistanceType_ Eps,
+                             DatumOperation_t OpFunc ){
+    return VisitDatumWithinRadius<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Query, Eps, OpFunc,
+                                                                                  [](void) -> void { });
+}
+
+
+//This helper function counts the datum strictly closer than Eps to the query datum (including the query datum
+// itself, if present in the tree). Counting stops as soon as Limit datum have been found, so checking whether a datum
+// is a DBSCAN core datum (i.e., Limit = MinPts) only needs to visit a small part of a dense neighbourhood.
+//
+// The returned count is exact if it is less than Limit, and equal to Limit otherwise.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric >
+size_t CountDatumWithinRadius( const RTree_t & RTree,
+                               const ClusteringDatum_t & Query,
+                               typename ClusteringDatum_t::DistanceType_ Eps,
+                               size_t Limit = std::numeric_limits<size_t>::max() ){
+    size_t Count = 0;
+    if(Limit == 0) return Count;
+    VisitDatumWithinRadius<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Query, Eps,
+        [&Count,Limit](const ClusteringDatum_t &) -> bool {
+            return (++Count < Limit);
+        });
+    return Count;
+}
+
+
+//This helper function appends the address of each datum strictly closer than Eps to the query datum (including the
+// query datum itself, if present in the tree) to a caller-provided buffer. The buffer is not cleared, so it can be
+// reused across queries. No other heap allocations are performed.
+//
+template < typename RTree_t,  //A Boost.Geometry R*-tree, specifically.
+           typename ClusteringDatum_t,
+           typename DistanceMetric_t = EuclideanDistanceMetric,
+           typename Allocator_t = std::allocator<const ClusteringDatum_t *> >
+void GatherDatumWithinRadius( const RTree_t & RTree,
+                              const ClusteringDatum_t & Query,
+                              typename ClusteringDatum_t::DistanceType_ Eps,
+                              std::vector<const ClusteringDatum_t *, Allocator_t> & Out ){
+    VisitDatumWithinRadius<RTree_t, ClusteringDatum_t, DistanceMetric_t>(RTree, Query, Eps,
+        [&Out](const ClusteringDatum_t &nearby) -> bool {
+            Out.push_back( std::addressof(nearby) );
+            return true;
+        });
+    return;
+}
+
+#endif //YGOR_CLUSTERING_RADIUSQUERY_HPP
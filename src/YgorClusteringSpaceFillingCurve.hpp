@@ -0,0 +1,166 @@
+
+#ifndef YGOR_CLUSTERING_SPACEFILLINGCURVE_HPP
+#define YGOR_CLUSTERING_SPACEFILLINGCURVE_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <array>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+
+#include "YgorClusteringParallel.hpp"
+
+
+//The order in which clustering routines visit datum.
+//
+// - RTree visits datum in the order that a full traversal of the R*-tree walks them.
+// - Morton visits datum along a Z-order curve, i.e., ordered by their interleaved (quantized) coordinate bits.
+// - Hilbert visits datum along a Hilbert curve. Consecutive datum are always close together, which makes it
+//   somewhat more local than Morton order, at the cost of a slightly more expensive key.
+//
+// Along either curve, consecutive range queries tend to touch the same R*-tree nodes, which are then still in cache.
+//
+enum class ClusteringTraversalOrder {
+    RTree,
+    Morton,
+    Hilbert
+};
+
+
+//Interleaves the low Bits bits of each coordinate into a single key, most significant bits first.
+template <size_t SpatialDimensionCount>
+uint64_t InterleaveBits(const std::array<uint32_t, SpatialDimensionCount> &X, unsigned int Bits){
+    uint64_t Key = 0;
+    for(unsigned int b = Bits; b-- > 0; ){
+        for(size_t d = 0; d < SpatialDimensionCount; ++d){
+            Key = (Key << 1) | static_cast<uint64_t>((X[d] >> b) & 1U);
+        }
+    }
+    return Key;
+}
+
+//Computes the Hilbert key of a point with Bits-bit integer coordinates.
+//
+// This uses the algorithm by J. Skilling ("Programming the Hilbert curve", AIP Conf. Proc. 707, 2004), which works in
+// any number of dimensions: the coordinates are transformed in-place into the 'transposed' Hilbert index, whose bits
+// are then interleaved.
+//
+template <size_t SpatialDimensionCount>
+uint64_t HilbertKey(std::array<uint32_t, SpatialDimensionCount> X, unsigned int Bits){
+    if(Bits == 0) return 0;
+    const uint32_t M = static_cast<uint32_t>(1) << (Bits - 1);
+
+    //Inverse undo.
+    for(uint32_t Q = M; Q > 1; Q >>= 1){
+        const uint32_t P = Q - 1;
+        for(size_t d = 0; d < SpatialDimensionCount; ++d){
+            if(X[d] & Q){
+                X[0] ^= P;
+            }else{
+                const uint32_t t = (X[0] ^ X[d]) & P;
+                X[0] ^= t;
+                X[d] ^= t;
+            }
+        }
+    }
+
+    //Gray encode.
+    for(size_t d = 1; d < SpatialDimensionCount; ++d) X[d] ^= X[d - 1];
+    uint32_t t = 0;
+    for(uint32_t Q = M; Q > 1; Q >>= 1){
+        if(X[SpatialDimensionCount - 1] & Q) t ^= Q - 1;
+    }
+    for(auto &x : X) x ^= t;
+
+    return InterleaveBits<SpatialDimensionCount>(X, Bits);
+}
+
+
+//This class maps datum to their position along a space-filling curve. Coordinates are quantized to a grid spanning
+// the given bounding box (e.g., of the R*-tree), with as many bits per axis as fit in a 64-bit key.
+//
+// Any point type with a 'Coordinates' array member (e.g., ClusteringDatum or IndexedClusteringPoint) can be keyed.
+// Keys are meaningless for ClusteringTraversalOrder::RTree and are always zero.
+//
+template <size_t SpatialDimensionCount>
+class SpaceFillingCurveKeyer {
+    public:
+        static constexpr unsigned int Bits = (SpatialDimensionCount == 1) ? 32
+                                           : std::max<unsigned int>(1, 64 / SpatialDimensionCount);
+
+    private:
+        ClusteringTraversalOrder Order;
+        std::array<double, SpatialDimensionCount> Min;
+        std::array<double, SpatialDimensionCount> Scale;
+
+    public:
+        SpaceFillingCurveKeyer(ClusteringTraversalOrder O,
+                               const std::array<double, SpatialDimensionCount> &Lower,
+                               const std::array<double, SpatialDimensionCount> &Upper) : Order(O), Min(Lower) {
+            const double Cells = std::ldexp(1.0, static_cast<int>(Bits)) - 1.0;
+            for(size_t d = 0; d < SpatialDimensionCount; ++d){
+                const double Extent = Upper[d] - Lower[d];
+                this->Scale[d] = (std::isfinite(Extent) && (0.0 < Extent)) ? (Cells / Extent) : 0.0;
+            }
+        }
+
+        template <typename Point_t>
+        uint64_t operator()(const Point_t &P) const {
+            if(this->Order == ClusteringTraversalOrder::RTree) return 0;
+
+            const double Cells = std::ldexp(1.0, static_cast<int>(Bits)) - 1.0;
+            std::array<uint32_t, SpatialDimensionCount> X;
+            for(size_t d = 0; d < SpatialDimensionCount; ++d){
+                const double q = (static_cast<double>(P.Coordinates[d]) - this->Min[d]) * this->Scale[d];
+                X[d] = static_cast<uint32_t>( std::clamp(q, 0.0, Cells) );
+            }
+            return (this->Order == ClusteringTraversalOrder::Hilbert) ? HilbertKey<SpatialDimensionCount>(X, Bits)
+                                                                      : InterleaveBits<SpatialDimensionCount>(X, Bits);
+        }
+};
+
+
+//This helper function reorders a list of datum addresses along a space-filling curve. Keys are computed and sorted
+// using a number of worker threads. Datum with identical keys retain no particular order.
+template < size_t SpatialDimensionCount,
+           typename Point_t >
+void SortAlongSpaceFillingCurve( std::vector<const Point_t *> &Datum,
+                                 const SpaceFillingCurveKeyer<SpatialDimensionCount> &Keyer,
+                                 size_t ThreadCount ){
+    const size_t N = Datum.size();
+    std::vector<std::pair<uint64_t, const Point_t *>> Keyed(N);
+    ParallelForEachIndex(N, ThreadCount, [&](size_t i) -> void {
+        Keyed[i] = std::make_pair(Keyer(*(Datum[i])), Datum[i]);
+    }, 4096);
+    ParallelSort(Keyed.begin(), Keyed.end(),
+                 [](const std::pair<uint64_t, const Point_t *> &A, const std::pair<uint64_t, const Point_t *> &B) -> bool {
+                     return (A.first < B.first);
+                 }, ThreadCount);
+    ParallelForEachIndex(N, ThreadCount, [&](size_t i) -> void {
+        Datum[i] = Keyed[i].second;
+    }, 4096);
+    return;
+}
+
+#endif //YGOR_CLUSTERING_SPACEFILLINGCURVE_HPP
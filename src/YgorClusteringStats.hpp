@@ -0,0 +1,146 @@
+
+#ifndef YGOR_CLUSTERING_STATS_HPP
+#define YGOR_CLUSTERING_STATS_HPP
+
+//Copyright Haley Clark 2015.
+//
+///////////////////////////////////////////////////////////////////////////////
+// This file is part of LibYgor.                                             //
+//                                                                           //
+// LibYgor is free software: you can redistribute it and/or modify           //
+// it under the terms of the GNU General Public License as published by      //
+// the Free Software Foundation, either version 3 of the License, or         //
+// (at your option) any later version.                                       //
+//                                                                           //
+// LibYgor is distributed in the hope that it will be useful,                //
+// but WITHOUT ANY WARRANTY; without even the implied warranty of            //
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the             //
+// GNU General Public License for more details.                              //
+//                                                                           //
+// You should have received a copy of the GNU General Public License         //
+// along with LibYgor.  If not, see <http://www.gnu.org/licenses/>.          //
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <chrono>
+
+
+//This class collects instrumentation from the clustering routines. It is useful for diagnosing slow runs, e.g., to
+// tell whether Eps is so large that each range query returns huge numbers of datum, whether the R*-tree bounding
+// boxes are so loose that most candidates are rejected by the distance filter, or where the time is being spent.
+//
+// Routines that accept a ClusteringStats pointer only collect instrumentation when the pointer is non-null. The
+// instrumented and uninstrumented code paths are separate template instantiations, so passing nullptr (the
+// default) costs nothing in the hot loops.
+//
+// Counters are added to, rather than overwritten, so a single object can accumulate statistics over several runs.
+// Assign a default-constructed object to start over.
+//
+struct ClusteringStats {
+    uint64_t RangeQueries = 0;        //Spatial index queries issued (range, box, or nearest-neighbour).
+    uint64_t CandidatesReturned = 0;  //Datum returned by the spatial index, before distance filtering.
+    uint64_t CandidatesAccepted = 0;  //Candidates that passed the distance filter (e.g., strictly closer than Eps).
+
+    uint64_t CoreCount = 0;           //Datum with at least MinPts datum (including themselves) within Eps.
+    uint64_t BorderCount = 0;         //Non-core datum assigned to a cluster.
+    uint64_t NoiseCount = 0;          //Datum assigned to no cluster.
+    uint64_t ClusterCount = 0;
+
+    uint64_t MaxSeedQueueLength = 0;  //The largest number of datum queued for expansion at once.
+
+    std::vector<std::pair<std::string, double>> PhaseSeconds; //Wall time for each phase, in the order run.
+
+    //The fraction of candidates that were accepted. Low values indicate loose bounding boxes (e.g., from a
+    // non-Euclidean metric or a poorly-tuned R*-tree) or wasted effort.
+    double AcceptanceRatio(void) const {
+        return (this->CandidatesReturned == 0) ? 0.0
+                                               : static_cast<double>(this->CandidatesAccepted)
+                                                 / static_cast<double>(this->CandidatesReturned);
+    }
+
+    //Adds wall time to a phase, creating it if needed.
+    void AddPhase(const std::string &Name, double Seconds){
+        auto it = std::find_if(this->PhaseSeconds.begin(), this->PhaseSeconds.end(),
+                               [&Name](const std::pair<std::string, double> &p) -> bool { return (p.first == Name); });
+        if(it == this->PhaseSeconds.end()){
+            this->PhaseSeconds.emplace_back(Name, Seconds);
+        }else{
+            it->second += Seconds;
+        }
+    }
+
+    //Adds the classification of a completed run, given the number of core and noise datum.
+    void AddClassification(uint64_t Total, uint64_t Core, uint64_t Noise, uint64_t Clusters){
+        this->CoreCount    += Core;
+        this->BorderCount  += Total - Core - Noise;
+        this->NoiseCount   += Noise;
+        this->ClusterCount += Clusters;
+    }
+
+    //Adds the counters (but not the phase timings) of another object, e.g., one filled by a single worker thread.
+    void MergeCounters(const ClusteringStats &rhs){
+        this->RangeQueries       += rhs.RangeQueries;
+        this->CandidatesReturned += rhs.CandidatesReturned;
+        this->CandidatesAccepted += rhs.CandidatesAccepted;
+        this->CoreCount          += rhs.CoreCount;
+        this->BorderCount        += rhs.BorderCount;
+        this->NoiseCount         += rhs.NoiseCount;
+        this->ClusterCount       += rhs.ClusterCount;
+        this->MaxSeedQueueLength  = std::max(this->MaxSeedQueueLength, rhs.MaxSeedQueueLength);
+    }
+
+    void Write(std::ostream &os) const {
+        os << "Range queries:         " << this->RangeQueries << std::endl
+           << "Candidates returned:   " << this->CandidatesReturned << std::endl
+           << "Candidates accepted:   " << this->CandidatesAccepted
+                                        << " (" << (100.0 * this->AcceptanceRatio()) << "%)" << std::endl
+           << "Core datum:            " << this->CoreCount << std::endl
+           << "Border datum:          " << this->BorderCount << std::endl
+           << "Noise datum:           " << this->NoiseCount << std::endl
+           << "Clusters:              " << this->ClusterCount << std::endl
+           << "Max seed queue length: " << this->MaxSeedQueueLength << std::endl;
+        for(const auto &p : this->PhaseSeconds){
+            os << "Phase '" << p.first << "': " << p.second << " s" << std::endl;
+        }
+    }
+};
+
+
+//This helper times a phase for the lifetime of the object, adding the elapsed wall time to a ClusteringStats object
+// on destruction. It does nothing (and never reads the clock) if the stats pointer is null.
+class ClusteringStatsPhaseTimer {
+    private:
+        ClusteringStats *Stats;
+        std::string Name;
+        std::chrono::steady_clock::time_point Start;
+
+    public:
+        ClusteringStatsPhaseTimer(ClusteringStats *S, const char *PhaseName) : Stats(S) {
+            if(this->Stats == nullptr) return;
+            this->Name = PhaseName;
+            this->Start = std::chrono::steady_clock::now();
+        }
+
+        ClusteringStatsPhaseTimer(const ClusteringStatsPhaseTimer &) = delete;
+        ClusteringStatsPhaseTimer & operator=(const ClusteringStatsPhaseTimer &) = delete;
+
+        //Records the phase immediately rather than on destruction.
+        void Stop(void){
+            if(this->Stats == nullptr) return;
+            this->Stats->AddPhase(this->Name,
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - this->Start).count());
+            this->Stats = nullptr;
+        }
+
+        ~ClusteringStatsPhaseTimer(){
+            this->Stop();
+        }
+};
+
+#endif //YGOR_CLUSTERING_STATS_HPP